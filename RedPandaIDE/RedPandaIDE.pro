@@ -122,6 +122,11 @@ SOURCES += \
     compiler/compilermanager.cpp \
     compiler/executablerunner.cpp \
     compiler/filecompiler.cpp \
+    compiler/nativeprojectcompiler.cpp \
+    compiler/objectcache.cpp \
+    compiler/compilerprobecache.cpp \
+    compiler/caseprocess.cpp \
+    compiler/ojstresstestrunner.cpp \
     compiler/stdincompiler.cpp \
     debugger/debugger.cpp \
     debugger/gdbmidebugger.cpp \
@@ -134,6 +139,7 @@ SOURCES += \
     parser/cpptokenizer.cpp \
     parser/parserutils.cpp \
     parser/statementmodel.cpp \
+    parser/symbolindex.cpp \
     problems/competitivecompenionhandler.cpp \
     problems/freeprojectsetformat.cpp \
     problems/ojproblemset.cpp \
@@ -238,7 +244,8 @@ SOURCES += \
     widgets/searchresultview.cpp \
     widgets/shortcutinputedit.cpp \
     widgets/shrinkabletabwidget.cpp \
-    widgets/signalmessagedialog.cpp
+    widgets/signalmessagedialog.cpp \
+    widgets/symbolsearchdialog.cpp
 
 HEADERS += \
     SimpleIni.h \
@@ -254,6 +261,11 @@ HEADERS += \
     compiler/compilermanager.h \
     compiler/executablerunner.h \
     compiler/filecompiler.h \
+    compiler/nativeprojectcompiler.h \
+    compiler/objectcache.h \
+    compiler/compilerprobecache.h \
+    compiler/caseprocess.h \
+    compiler/ojstresstestrunner.h \
     compiler/ojproblemcasesrunner.h \
     compiler/projectcompiler.h \
     compiler/runner.h \
@@ -270,6 +282,7 @@ HEADERS += \
     parser/cpptokenizer.h \
     parser/parserutils.h \
     parser/statementmodel.h \
+    parser/symbolindex.h \
     problems/competitivecompenionhandler.h \
     problems/freeprojectsetformat.h \
     problems/ojproblemset.h \
@@ -374,7 +387,8 @@ HEADERS += \
     widgets/searchresultview.h \
     widgets/shortcutinputedit.h \
     widgets/shrinkabletabwidget.h \
-    widgets/signalmessagedialog.h
+    widgets/signalmessagedialog.h \
+    widgets/symbolsearchdialog.h
 
 FORMS += \
     settingsdialog/compilerautolinkwidget.ui \
@@ -432,7 +446,8 @@ FORMS += \
     widgets/projectalreadyopendialog.ui \
     widgets/searchdialog.ui \
     widgets/searchinfiledialog.ui \
-    widgets/signalmessagedialog.ui
+    widgets/signalmessagedialog.ui \
+    widgets/symbolsearchdialog.ui
 
 ENABLE_SDCC {
     DEFINES += ENABLE_SDCC
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "caseprocess.h"
+#include "compilermanager.h"
+
+#ifdef Q_OS_LINUX
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CASE_PROCESS_READ_SIZE 65536
+//max time a poll() may sleep before the exit status is checked again, when there's no pidfd
+#define CASE_PROCESS_POLL_INTERVAL 100
+//waitForFinished() returns when this much output is read, so that the caller can take it
+#define CASE_PROCESS_MAX_PENDING_OUTPUT (1024*1024)
+
+static void setNonBlocking(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void ignoreSigPipe()
+{
+    //writing to a program that doesn't read its input must not kill the IDE
+    static std::once_flag flag;
+    std::call_once(flag, []{
+        struct sigaction action;
+        if (sigaction(SIGPIPE, nullptr, &action) == 0 && action.sa_handler == SIG_DFL) {
+            action.sa_handler = SIG_IGN;
+            sigaction(SIGPIPE, &action, nullptr);
+        }
+    });
+}
+
+CaseProcess::CaseProcess():
+    mMergeStderr{true},
+    mCpuTimeLimit{0},
+    mAddressSpaceLimit{0},
+    mPid{-1},
+    mPidFd{-1},
+    mRunning{false},
+    mStdinFd{-1},
+    mStdoutFd{-1},
+    mStderrFd{-1},
+    mUsageFd{-1},
+    mPendingInputOffset{0},
+    mCloseInputWhenWritten{false},
+    mStatus{0},
+    mCpuTime{0},
+    mPeakMemory{0}
+{
+}
+
+CaseProcess::~CaseProcess()
+{
+    if (mRunning) {
+        kill();
+        reap(true);
+    }
+    closeFd(mStdinFd);
+    closeFd(mStdoutFd);
+    closeFd(mStderrFd);
+    closeFd(mUsageFd);
+    closeFd(mPidFd);
+}
+
+void CaseProcess::setProgram(const QString &program)
+{
+    mProgram = program;
+}
+
+void CaseProcess::setArguments(const QStringList &arguments)
+{
+    mArguments = arguments;
+}
+
+void CaseProcess::setWorkingDirectory(const QString &dir)
+{
+    mWorkingDirectory = dir;
+}
+
+void CaseProcess::setEnvironment(const QProcessEnvironment &env)
+{
+    mEnvironment = env;
+}
+
+void CaseProcess::setMergeStderr(bool merge)
+{
+    mMergeStderr = merge;
+}
+
+void CaseProcess::setStandardInputFile(const QString &fileName)
+{
+    mStandardInputFile = fileName;
+}
+
+void CaseProcess::setCpuTimeLimit(qint64 msecs)
+{
+    mCpuTimeLimit = msecs;
+}
+
+void CaseProcess::setAddressSpaceLimit(qint64 bytes)
+{
+    mAddressSpaceLimit = bytes;
+}
+
+void CaseProcess::setLauncher(const QString &launcher)
+{
+    mLauncher = launcher;
+}
+
+bool CaseProcess::start()
+{
+    //everything the child needs is prepared before fork(),
+    //only async-signal-safe functions may be called in the child of a multithreaded process
+    int inputFd = -1;
+    if (!mStandardInputFile.isEmpty()) {
+        inputFd = open(QFile::encodeName(mStandardInputFile).constData(), O_RDONLY | O_CLOEXEC);
+        if (inputFd < 0) {
+            mErrorString = QString::fromLocal8Bit(strerror(errno));
+            return false;
+        }
+    }
+    // stdin, stdout, stderr, exec error, usage report
+    int pipes[5][2] = {{-1,-1},{-1,-1},{-1,-1},{-1,-1},{-1,-1}};
+    for (int i=0;i<5;i++) {
+        if ((i==0 && inputFd >= 0) || (i==2 && mMergeStderr) || (i==4 && mLauncher.isEmpty()))
+            continue;
+        if (pipe2(pipes[i], O_CLOEXEC)<0) {
+            mErrorString = QString::fromLocal8Bit(strerror(errno));
+            for (auto& p : pipes) {
+                closeFd(p[0]);
+                closeFd(p[1]);
+            }
+            closeFd(inputFd);
+            return false;
+        }
+    }
+
+    QByteArray program = QFile::encodeName(mProgram);
+    QList<QByteArray> arguments;
+    if (!mLauncher.isEmpty()) {
+        //the program's peak memory would include the IDE's, if it were forked from the IDE
+        arguments.append(QFile::encodeName(mLauncher));
+        arguments.append(QByteArray::number(RPF_REPORT_USAGE));
+        arguments.append(QByteArray::number(pipes[4][1]));
+    }
+    arguments.append(program);
+    foreach (const QString& argument, mArguments)
+        arguments.append(argument.toLocal8Bit());
+    std::vector<char*> argv;
+    for (QByteArray& argument : arguments)
+        argv.push_back(argument.data());
+    argv.push_back(nullptr);
+    QList<QByteArray> environment;
+    foreach (const QString& key, mEnvironment.keys())
+        environment.append((key + "=" + mEnvironment.value(key)).toLocal8Bit());
+    std::vector<char*> envp;
+    for (QByteArray& value : environment)
+        envp.push_back(value.data());
+    envp.push_back(nullptr);
+    QByteArray workingDirectory = QFile::encodeName(mWorkingDirectory);
+    QByteArray executable = arguments.front();
+    ignoreSigPipe();
+
+    struct rlimit cpuLimit;
+    //SIGXCPU at the soft limit, SIGKILL one second later
+    cpuLimit.rlim_cur = (mCpuTimeLimit + 999) / 1000 + 1;
+    cpuLimit.rlim_max = cpuLimit.rlim_cur + 1;
+    struct rlimit addressSpaceLimit;
+    addressSpaceLimit.rlim_cur = mAddressSpaceLimit;
+    addressSpaceLimit.rlim_max = mAddressSpaceLimit;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, nullptr);
+        //ignored signals are kept by execve()
+        signal(SIGPIPE, SIG_DFL);
+        //own process group, so that processes started by the program can be killed with it
+        setpgid(0, 0);
+        dup2(inputFd >= 0 ? inputFd : pipes[0][0], STDIN_FILENO);
+        dup2(pipes[1][1], STDOUT_FILENO);
+        dup2(mMergeStderr ? pipes[1][1] : pipes[2][1], STDERR_FILENO);
+        if (pipes[4][1] >= 0)
+            fcntl(pipes[4][1], F_SETFD, 0);
+        if ((workingDirectory.isEmpty() || chdir(workingDirectory.constData()) == 0)
+                && (mCpuTimeLimit <= 0 || setrlimit(RLIMIT_CPU, &cpuLimit) == 0)
+                && (mAddressSpaceLimit <= 0 || setrlimit(RLIMIT_AS, &addressSpaceLimit) == 0)) {
+            execve(executable.constData(), argv.data(), envp.data());
+        }
+        int error = errno;
+        ssize_t written = ::write(pipes[3][1], &error, sizeof(error));
+        Q_UNUSED(written);
+        _exit(127);
+    }
+    closeFd(inputFd);
+    closeFd(pipes[0][0]);
+    closeFd(pipes[1][1]);
+    closeFd(pipes[2][1]);
+    closeFd(pipes[3][1]);
+    closeFd(pipes[4][1]);
+    mStdinFd = pipes[0][1];
+    mStdoutFd = pipes[1][0];
+    mStderrFd = pipes[2][0];
+    mUsageFd = pipes[4][0];
+    if (pid < 0) {
+        mErrorString = QString::fromLocal8Bit(strerror(errno));
+        closeFd(pipes[3][0]);
+        closeFd(mStdinFd);
+        closeFd(mStdoutFd);
+        closeFd(mStderrFd);
+        closeFd(mUsageFd);
+        return false;
+    }
+    mPid = pid;
+    mRunning = true;
+
+    //the exec error pipe is closed without data when execve() succeeds
+    int error = 0;
+    ssize_t n;
+    do {
+        n = ::read(pipes[3][0], &error, sizeof(error));
+    } while (n < 0 && errno == EINTR);
+    closeFd(pipes[3][0]);
+    if (n == sizeof(error)) {
+        mErrorString = QString::fromLocal8Bit(strerror(error));
+        reap(true);
+        closeFd(mStdinFd);
+        closeFd(mStdoutFd);
+        closeFd(mStderrFd);
+        closeFd(mUsageFd);
+        return false;
+    }
+#ifdef SYS_pidfd_open
+    mPidFd = syscall(SYS_pidfd_open, mPid, 0);
+#endif
+    if (mStdinFd >= 0)
+        setNonBlocking(mStdinFd);
+    setNonBlocking(mStdoutFd);
+    if (mStderrFd >= 0)
+        setNonBlocking(mStderrFd);
+    return true;
+}
+
+void CaseProcess::write(const QByteArray &data)
+{
+    if (mStdinFd < 0)
+        return;
+    if (mPendingInputOffset > 0) {
+        mPendingInput.remove(0, mPendingInputOffset);
+        mPendingInputOffset = 0;
+    }
+    mPendingInput.append(data);
+    writeInput();
+}
+
+void CaseProcess::closeWriteChannel()
+{
+    mCloseInputWhenWritten = true;
+    if (mPendingInputOffset >= mPendingInput.size())
+        closeFd(mStdinFd);
+}
+
+bool CaseProcess::waitForFinished(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (true) {
+        if (reap(false)) {
+            //collect what is left in the pipes, without waiting for processes that inherited them
+            transfer(0);
+            return true;
+        }
+        //with a pidfd, poll() wakes up as soon as the process exits
+        int timeout = mPidFd >= 0 ? -1 : CASE_PROCESS_POLL_INTERVAL;
+        if (msecs >= 0) {
+            qint64 remaining = msecs - timer.elapsed();
+            if (remaining <= 0)
+                return false;
+            timeout = mPidFd >= 0 ? remaining : std::min<qint64>(remaining, CASE_PROCESS_POLL_INTERVAL);
+        }
+        transfer(timeout);
+        if (mStdout.size() + mStderr.size() >= CASE_PROCESS_MAX_PENDING_OUTPUT)
+            return false;
+    }
+}
+
+void CaseProcess::kill()
+{
+    if (!mRunning)
+        return;
+    ::kill(-mPid, SIGKILL);
+    ::kill(mPid, SIGKILL);
+}
+
+bool CaseProcess::isRunning() const
+{
+    return mRunning;
+}
+
+QByteArray CaseProcess::readAllStandardOutput()
+{
+    QByteArray result;
+    result.swap(mStdout);
+    return result;
+}
+
+QByteArray CaseProcess::readAllStandardError()
+{
+    QByteArray result;
+    result.swap(mStderr);
+    return result;
+}
+
+const QString &CaseProcess::errorString() const
+{
+    return mErrorString;
+}
+
+int CaseProcess::exitCode() const
+{
+    return WIFEXITED(mStatus) ? WEXITSTATUS(mStatus) : -1;
+}
+
+int CaseProcess::terminationSignal() const
+{
+    return WIFSIGNALED(mStatus) ? WTERMSIG(mStatus) : 0;
+}
+
+qint64 CaseProcess::cpuTime() const
+{
+    return mCpuTime;
+}
+
+qint64 CaseProcess::peakMemory() const
+{
+    return mPeakMemory;
+}
+
+bool CaseProcess::reap(bool block)
+{
+    if (!mRunning)
+        return true;
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    pid_t result;
+    do {
+        result = wait4(mPid, &status, block ? 0 : WNOHANG, &usage);
+    } while (result < 0 && errno == EINTR);
+    if (result == 0)
+        return false;
+    mRunning = false;
+    closeFd(mPidFd);
+    if (result == mPid) {
+        mStatus = status;
+        mCpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+                + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+        //ru_maxrss is in kilobytes
+        mPeakMemory = (qint64)usage.ru_maxrss * 1024;
+        //the launcher has written its report before exiting, unless it's killed
+        if (mUsageFd >= 0)
+            readLauncherUsage();
+    }
+    closeFd(mUsageFd);
+    return true;
+}
+
+bool CaseProcess::readLauncherUsage()
+{
+    setNonBlocking(mUsageFd);
+    QByteArray report;
+    readFrom(mUsageFd, report);
+    QList<QByteArray> values = report.trimmed().split(' ');
+    if (values.length() != 4)
+        return false;
+    mStatus = values[0].toInt();
+    mCpuTime = (values[1].toLongLong() + values[2].toLongLong()) / 1000;
+    mPeakMemory = values[3].toLongLong() * 1024;
+    return true;
+}
+
+void CaseProcess::transfer(int timeout)
+{
+    struct pollfd fds[4];
+    int count = 0;
+    if (mPidFd >= 0)
+        fds[count++] = {mPidFd, POLLIN, 0};
+    if (mStdoutFd >= 0)
+        fds[count++] = {mStdoutFd, POLLIN, 0};
+    if (mStderrFd >= 0)
+        fds[count++] = {mStderrFd, POLLIN, 0};
+    if (mStdinFd >= 0 && mPendingInputOffset < mPendingInput.size())
+        fds[count++] = {mStdinFd, POLLOUT, 0};
+    if (poll(fds, count, timeout) <= 0)
+        return;
+    for (int i=0;i<count;i++) {
+        if (fds[i].revents == 0)
+            continue;
+        if (fds[i].fd == mStdoutFd)
+            readFrom(mStdoutFd, mStdout);
+        else if (fds[i].fd == mStderrFd)
+            readFrom(mStderrFd, mStderr);
+        else if (fds[i].fd == mStdinFd)
+            writeInput();
+    }
+}
+
+void CaseProcess::readFrom(int &fd, QByteArray &buffer)
+{
+    char data[CASE_PROCESS_READ_SIZE];
+    while (fd >= 0) {
+        ssize_t n = ::read(fd, data, sizeof(data));
+        if (n > 0) {
+            buffer.append(data, n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeFd(fd);
+        }
+    }
+}
+
+void CaseProcess::writeInput()
+{
+    while (mStdinFd >= 0 && mPendingInputOffset < mPendingInput.size()) {
+        ssize_t n = ::write(mStdinFd, mPendingInput.constData() + mPendingInputOffset,
+                            mPendingInput.size() - mPendingInputOffset);
+        if (n > 0) {
+            mPendingInputOffset += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            //the program doesn't read its input (EPIPE)
+            closeFd(mStdinFd);
+        }
+    }
+    if (mPendingInputOffset >= mPendingInput.size()) {
+        mPendingInput.clear();
+        mPendingInputOffset = 0;
+    }
+    if (mCloseInputWhenWritten)
+        closeFd(mStdinFd);
+}
+
+void CaseProcess::closeFd(int &fd)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+#endif
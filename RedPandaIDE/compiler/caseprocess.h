@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CASEPROCESS_H
+#define CASEPROCESS_H
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <QByteArray>
+#include <QProcessEnvironment>
+#include <QString>
+#include <QStringList>
+#include <sys/types.h>
+
+/*
+ * Child process of a problem case, started with fork/exec instead of QProcess,
+ * so that its cpu time and peak memory can be read from wait4(), and limited by setrlimit().
+ */
+class CaseProcess
+{
+public:
+    CaseProcess();
+    ~CaseProcess();
+    CaseProcess(const CaseProcess&)=delete;
+    CaseProcess& operator=(const CaseProcess&)=delete;
+
+    void setProgram(const QString& program);
+    void setArguments(const QStringList& arguments);
+    void setWorkingDirectory(const QString& dir);
+    void setEnvironment(const QProcessEnvironment& env);
+    void setMergeStderr(bool merge);
+    //the file is connected to the program's stdin, instead of a pipe written by write()
+    void setStandardInputFile(const QString& fileName);
+    //0 means no limit
+    void setCpuTimeLimit(qint64 msecs);
+    void setAddressSpaceLimit(qint64 bytes);
+    //run the program through consolepauser, which reports the program's resource usage
+    void setLauncher(const QString& launcher);
+
+    bool start();
+    void write(const QByteArray& data);
+    void closeWriteChannel();
+    //returns true when the process has exited, a negative msecs waits forever
+    bool waitForFinished(int msecs);
+    void kill();
+    bool isRunning() const;
+
+    QByteArray readAllStandardOutput();
+    QByteArray readAllStandardError();
+
+    const QString& errorString() const;
+    int exitCode() const;
+    //0 if the process exited normally
+    int terminationSignal() const;
+    //user + system time, in milliseconds
+    qint64 cpuTime() const;
+    //peak resident set size, in bytes
+    qint64 peakMemory() const;
+private:
+    bool reap(bool block);
+    bool readLauncherUsage();
+    void transfer(int timeout);
+    void readFrom(int& fd, QByteArray& buffer);
+    void writeInput();
+    static void closeFd(int& fd);
+private:
+    QString mProgram;
+    QStringList mArguments;
+    QString mWorkingDirectory;
+    QProcessEnvironment mEnvironment;
+    bool mMergeStderr;
+    QString mStandardInputFile;
+    qint64 mCpuTimeLimit;
+    qint64 mAddressSpaceLimit;
+    QString mLauncher;
+
+    pid_t mPid;
+    //readable when the process exits, -1 if pidfd_open() isn't supported
+    int mPidFd;
+    bool mRunning;
+    int mStdinFd;
+    int mStdoutFd;
+    int mStderrFd;
+    int mUsageFd;
+    QByteArray mPendingInput;
+    int mPendingInputOffset;
+    bool mCloseInputWhenWritten;
+    QByteArray mStdout;
+    QByteArray mStderr;
+    int mStatus;
+    qint64 mCpuTime;
+    qint64 mPeakMemory;
+    QString mErrorString;
+};
+#endif
+
+#endif // CASEPROCESS_H
@@ -21,10 +21,20 @@
 #include "compilermanager.h"
 #include "../systemconsts.h"
 
+#include <algorithm>
 #include <cmath>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
 #include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutex>
 #include <QProcess>
+#include <QRegularExpression>
 #include <QString>
+#include <QUrl>
 #include <QTime>
 #include <QApplication>
 #include "../editor.h"
@@ -35,7 +45,12 @@
 #include "qt_utils/charsetinfo.h"
 #include "../project.h"
 
-#define COMPILE_PROCESS_END "---//END//----"
+#define MAX_PRECOMPILED_HEADERS 16
+#define PRECOMPILED_HEADER_TIMEOUT 60000
+#define OBJECT_CACHE_MAX_SIZE (2LL*1024*1024*1024)
+#define PREPROCESS_TIMEOUT 60000
+#define ISSUE_BATCH_SIZE 256
+#define ISSUE_BATCH_INTERVAL 100
 
 Compiler::Compiler(const QString &filename, bool onlyCheckSyntax):
     QThread{},
@@ -43,7 +58,13 @@ Compiler::Compiler(const QString &filename, bool onlyCheckSyntax):
     mFilename{filename},
     mRebuild{false},
     mParserForFile{},
-    mForceEnglishOutput{false}
+    mForceEnglishOutput{false},
+    mStop{false},
+    mStructuredDiagnostics{false},
+    mLinkPhaseStart{-1},
+    mJsonDepth{0},
+    mJsonInString{false},
+    mJsonEscaped{false}
 {
     getParserForFile(filename);
 }
@@ -52,6 +73,8 @@ void Compiler::run()
 {
     emit compileStarted();
     auto action = finally([this]{
+        releasePrecompiledHeader();
+        flushIssues();
         emit compileFinished(mFilename);
     });
     try {
@@ -63,9 +86,10 @@ void Compiler::run()
         }
         mErrorCount = 0;
         mWarningCount = 0;
-        QElapsedTimer timer;
-        timer.start();
-        runCommand(mCompiler, mArguments, mDirectory, pipedText());
+        mLinkPhaseStart = -1;
+        mBuildTimer.start();
+        if (!fetchOutputFromCache())
+            runMainCommand();
         for(int i=0;i<mExtraArgumentsList.count();i++) {
             if (!beforeRunExtraCommand(i))
                 break;
@@ -77,6 +101,8 @@ void Compiler::run()
             }
             runCommand(mExtraCompilersList[i],mExtraArgumentsList[i],mDirectory, pipedText(),mExtraOutputFilesList[i]);
         }
+        if (!mStop)
+            storeOutputToCache();
         log("");
         log(tr("Compile Result:"));
         log("------------------");
@@ -87,7 +113,16 @@ void Compiler::run()
             QLocale locale = QLocale::system();
             log(tr("- Output Size: %1").arg(locale.formattedDataSize(QFileInfo(mOutputFile).size())));
         }
-        log(tr("- Compilation Time: %1 secs").arg(timer.elapsed() / 1000.0));
+        qint64 elapsed = mBuildTimer.elapsed();
+        log(tr("- Compilation Time: %1 secs").arg(elapsed / 1000.0));
+        if (mLinkPhaseStart>=0) {
+            log(tr("- Compile Phase: %1 secs").arg(mLinkPhaseStart / 1000.0));
+            log(tr("- Link Phase: %1 secs").arg((elapsed - mLinkPhaseStart) / 1000.0));
+        }
+        if (mObjectCache) {
+            log(tr("- Object Cache: %1 hit(s), %2 miss(es)")
+                .arg(mObjectCache->hits()).arg(mObjectCache->misses()));
+        }
     } catch (CompileError e) {
         emit compileErrorOccured(e.reason());
     }
@@ -238,13 +273,29 @@ bool Compiler::beforeRunExtraCommand(int /* idx */)
     return true;
 }
 
+void Compiler::runMainCommand()
+{
+    runCommand(mCompiler, mArguments, mDirectory, pipedText());
+}
+
+bool Compiler::fetchOutputFromCache()
+{
+    return false;
+}
+
+void Compiler::storeOutputToCache()
+{
+
+}
+
 void Compiler::processOutput(QString &line)
 {
     if (line == COMPILE_PROCESS_END) {
         if (mLastIssue) {
-            emit compileIssue(mLastIssue);
+            addIssue(mLastIssue);
             mLastIssue.reset();
         }
+        flushIssues();
         return;
     }
     if (line.startsWith(">>>"))
@@ -255,7 +306,7 @@ void Compiler::processOutput(QString &line)
             mLastIssue->filename = getFileNameFromOutputLine(line);
             //qDebug()<<line;
             mLastIssue->line = getLineNumberFromOutputLine(line);
-            emit compileIssue(mLastIssue);
+            addIssue(mLastIssue);
             mLastIssue.reset();
             return;
     }
@@ -272,7 +323,7 @@ void Compiler::processOutput(QString &line)
             issue->column = getColunmnFromOutputLine(line);
         issue->type = getIssueTypeFromOutputLine(line);
         issue->description = inFilePrefix + issue->filename;
-        emit compileIssue(issue);
+        addIssue(issue);
         return;
     } else if(line.startsWith(fromPrefix)) {
         line.remove(0,fromPrefix.length());
@@ -282,7 +333,7 @@ void Compiler::processOutput(QString &line)
             issue->column = getColunmnFromOutputLine(line);
         issue->type = getIssueTypeFromOutputLine(line);
         issue->description = "                 from " + issue->filename;
-        emit compileIssue(issue);
+        addIssue(issue);
         return;
     }
 
@@ -307,7 +358,7 @@ void Compiler::processOutput(QString &line)
                     i++;
                 }
                 mLastIssue->endColumn = mLastIssue->column+i-pos;
-                emit compileIssue(mLastIssue);
+                addIssue(mLastIssue);
                 mLastIssue.reset();
             }
         }
@@ -315,7 +366,7 @@ void Compiler::processOutput(QString &line)
     }
 
     if (mLastIssue) {
-        emit compileIssue(mLastIssue);
+        addIssue(mLastIssue);
         mLastIssue.reset();
     }
 
@@ -337,7 +388,7 @@ void Compiler::processOutput(QString &line)
     if (issue->line<=0 && (issue->filename=="ld" || issue->filename=="lld")) {
         mLastIssue = issue;
     } else if (issue->line<=0) {
-        emit compileIssue(issue);
+        addIssue(issue);
     } else
         mLastIssue = issue;
 }
@@ -702,15 +753,9 @@ bool Compiler::parseForceUTF8ForAutolink(const QString &filename, QSet<QString>
     return false;
 }
 
-void Compiler::runCommand(const QString &cmd, const QStringList &arguments, const QString &workingDir, const QByteArray& inputText, const QString& outputFile)
+QProcessEnvironment Compiler::getProcessEnvironment(const QString &cmd)
 {
-    QProcess process;
-    mStop = false;
-    bool errorOccurred = false;
-    process.setProgram(cmd);
     QString cmdDir = extractFileDir(cmd);
-    bool compilerErrorUTF8=compilerSet()->isCompilerInfoUsingUTF8();
-    bool outputUTF8=compilerSet()->forceUTF8();
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
 #ifdef Q_OS_WIN
     QStringList binDirs=compilerSet()->binDirs();
@@ -737,7 +782,294 @@ void Compiler::runCommand(const QString &cmd, const QStringList &arguments, cons
     env.insert("LDFLAGS","");
     env.insert("CFLAGS","");
     env.insert("CXXFLAGS","");
-    process.setProcessEnvironment(env);
+    return env;
+}
+
+//the leading "#include <...>" lines, which rarely change while editing
+static QString leadingSystemIncludes(const QString& content)
+{
+    static QRegularExpression includeRegex("^(#\\s*include\\s*<[^>]+>)\\s*(//.*)?$");
+    QString result;
+    bool inComment = false;
+    int start = 0;
+    while (start < content.length()) {
+        int end = content.indexOf('\n', start);
+        if (end < 0)
+            end = content.length();
+        QString line = content.mid(start, end-start).trimmed();
+        start = end + 1;
+        if (inComment) {
+            int pos = line.indexOf("*/");
+            if (pos >= 0) {
+                if (pos+2 != line.length())
+                    break;
+                inComment = false;
+            }
+            continue;
+        }
+        if (line.isEmpty() || line.startsWith("//"))
+            continue;
+        if (line.startsWith("/*")) {
+            int pos = line.indexOf("*/", 2);
+            if (pos < 0)
+                inComment = true;
+            else if (pos+2 != line.length())
+                break;
+            continue;
+        }
+        QRegularExpressionMatch match = includeRegex.match(line);
+        if (!match.hasMatch())
+            break;
+        result += match.captured(1) + "\n";
+    }
+    return result;
+}
+
+//guards the lock table and the users count only, a header is built under its own lock
+static QMutex precompiledHeaderMutex;
+static QHash<QString, std::shared_ptr<QMutex>> precompiledHeaderLocks;
+//compiles using a header, it's not pruned until they are finished
+static QHash<QString, int> precompiledHeaderUsers;
+
+QStringList Compiler::getPrecompiledHeaderArguments(bool isCpp, const QStringList &arguments, const QString &content)
+{
+    if (!compilerSet()->usePrecompiledHeader()
+            || !CompilerInfoManager::supportPrecompiledHeader(compilerSet()->compilerType()))
+        return QStringList();
+    QString includes = leadingSystemIncludes(content);
+    if (includes.isEmpty())
+        return QStringList();
+    QStringList flags;
+    for (int i=0;i<arguments.count();i++) {
+        if (arguments[i] == "-x") {
+            i++;
+            continue;
+        }
+        if (arguments[i] == "-" || arguments[i] == "-fsyntax-only")
+            continue;
+        flags.append(arguments[i]);
+    }
+    QString language = isCpp ? "c++-header" : "c-header";
+
+    //the cache key changes with the compiler binary, the flags and the included headers
+    QFileInfo compilerInfo(mCompiler);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(mCompiler.toUtf8());
+    hash.addData(QByteArray::number(compilerInfo.size()));
+    hash.addData(QByteArray::number(compilerInfo.lastModified().toMSecsSinceEpoch()));
+    hash.addData(language.toUtf8());
+    hash.addData(flags.join('\n').toUtf8());
+    hash.addData(includes.toUtf8());
+    QString baseDir = includeTrailingPathDelimiter(pSettings->dirs().cache()) + "pch";
+    QString dir = includeTrailingPathDelimiter(baseDir) + QString::fromLatin1(hash.result().toHex());
+    QString header = includeTrailingPathDelimiter(dir) + "prefix.h";
+    QString pchFile = header + (compilerSet()->compilerType() == CompilerType::Clang ? ".pch" : ".gch");
+    QString failedMark = includeTrailingPathDelimiter(dir) + "failed";
+    QString usedMark = includeTrailingPathDelimiter(dir) + "used";
+
+    std::shared_ptr<QMutex> headerLock;
+    {
+        QMutexLocker locker(&precompiledHeaderMutex);
+        headerLock = precompiledHeaderLocks.value(dir);
+        if (!headerLock) {
+            headerLock = std::make_shared<QMutex>();
+            precompiledHeaderLocks.insert(dir, headerLock);
+        }
+    }
+    //checks using other headers don't wait for this build
+    QMutexLocker locker(headerLock.get());
+    if (fileExists(failedMark))
+        return QStringList();
+    if (!fileExists(pchFile)) {
+        QDir().mkpath(dir);
+        if (!stringToFile(includes, header))
+            return QStringList();
+        log(tr("Precompiling the leading includes..."));
+        if (!buildPrecompiledHeader(language, flags, header, pchFile)) {
+            //don't retry until the compiler, the flags or the includes change
+            stringToFile("", failedMark);
+            log(tr("Failed to precompile the leading includes."));
+            return QStringList();
+        }
+        prunePrecompiledHeaders(baseDir, dir);
+    }
+    //the mark's time is the last use of the header
+    stringToFile("", usedMark);
+    releasePrecompiledHeader();
+    {
+        QMutexLocker tableLocker(&precompiledHeaderMutex);
+        precompiledHeaderUsers[dir]++;
+    }
+    mPrecompiledHeaderDir = dir;
+    log(tr("- Precompiled Header: %1").arg(pchFile));
+    return QStringList{"-include", header};
+}
+
+void Compiler::releasePrecompiledHeader()
+{
+    if (mPrecompiledHeaderDir.isEmpty())
+        return;
+    QMutexLocker locker(&precompiledHeaderMutex);
+    if (--precompiledHeaderUsers[mPrecompiledHeaderDir] <= 0)
+        precompiledHeaderUsers.remove(mPrecompiledHeaderDir);
+    mPrecompiledHeaderDir.clear();
+}
+
+void Compiler::prunePrecompiledHeaders(const QString &baseDir, const QString &keptDir)
+{
+    //keep the most recently used headers only
+    QMutexLocker locker(&precompiledHeaderMutex);
+    QFileInfoList entries = QDir(baseDir).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    if (entries.count() <= MAX_PRECOMPILED_HEADERS)
+        return;
+    QHash<QString, QDateTime> lastUsed;
+    foreach (const QFileInfo& entry, entries) {
+        QFileInfo usedMark(includeTrailingPathDelimiter(entry.absoluteFilePath()) + "used");
+        lastUsed.insert(entry.absoluteFilePath(),
+                        usedMark.exists() ? usedMark.lastModified() : entry.lastModified());
+    }
+    std::sort(entries.begin(), entries.end(),
+              [&lastUsed](const QFileInfo& a, const QFileInfo& b) {
+        return lastUsed.value(a.absoluteFilePath()) > lastUsed.value(b.absoluteFilePath());
+    });
+    for (int i=MAX_PRECOMPILED_HEADERS;i<entries.count();i++) {
+        QString entryDir = includeTrailingPathDelimiter(baseDir) + entries[i].fileName();
+        if (entryDir == keptDir)
+            continue;
+        //headers being built, checked or used by other compiles are kept
+        if (precompiledHeaderUsers.value(entryDir, 0) > 0)
+            continue;
+        std::shared_ptr<QMutex> entryLock = precompiledHeaderLocks.value(entryDir);
+        if (entryLock && !entryLock->tryLock())
+            continue;
+        QDir(entries[i].absoluteFilePath()).removeRecursively();
+        if (entryLock)
+            entryLock->unlock();
+    }
+}
+
+bool Compiler::buildPrecompiledHeader(const QString &language, const QStringList &arguments, const QString &header, const QString &pchFile)
+{
+    QString tempFile = pchFile + ".tmp";
+    QProcess process;
+    process.setProgram(mCompiler);
+    process.setProcessEnvironment(getProcessEnvironment(mCompiler));
+    process.setArguments(arguments + QStringList{"-x", language, header, "-o", tempFile});
+    process.setWorkingDirectory(extractFileDir(mFilename));
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start();
+    //a stopped check doesn't kill the build, the next check will use its result
+    if (!process.waitForFinished(PRECOMPILED_HEADER_TIMEOUT)) {
+        process.kill();
+        process.waitForFinished();
+        QFile::remove(tempFile);
+        return false;
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        QFile::remove(tempFile);
+        return false;
+    }
+    QFile::remove(pchFile);
+    return QFile::rename(tempFile, pchFile);
+}
+
+PObjectCache Compiler::createObjectCache()
+{
+    if (!compilerSet()->useObjectCache())
+        return PObjectCache();
+    return std::make_shared<ObjectCache>(
+                includeTrailingPathDelimiter(pSettings->dirs().cache()) + "objects",
+                OBJECT_CACHE_MAX_SIZE);
+}
+
+QByteArray Compiler::computeObjectCacheKey(const QString &compiler, const QString &sourceFile,
+                                           const QStringList &flags, const QStringList &keyArguments,
+                                           const QString &workingDir)
+{
+    QProcess process;
+    process.setProgram(compiler);
+    process.setProcessEnvironment(getProcessEnvironment(compiler));
+    process.setArguments(QStringList{"-E", sourceFile} + flags);
+    process.setWorkingDirectory(workingDir);
+    process.start();
+    if (!process.waitForFinished(PREPROCESS_TIMEOUT)) {
+        process.kill();
+        process.waitForFinished();
+        return QByteArray();
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+        return QByteArray();
+    //same preprocessed source, same arguments and same compiler binary give the same output
+    QFileInfo compilerInfo(compiler);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(compiler.toUtf8());
+    hash.addData(QByteArray::number(compilerInfo.size()));
+    hash.addData(QByteArray::number(compilerInfo.lastModified().toMSecsSinceEpoch()));
+    hash.addData(keyArguments.join('\n').toUtf8());
+    hash.addData(process.readAllStandardOutput());
+    return hash.result();
+}
+
+QStringList Compiler::getLinkInputsFingerprint(const QStringList &arguments, const QString &workingDir)
+{
+    QStringList libDirs;
+    QStringList libNames;
+    QStringList inputFiles;
+    QSet<QString> inputSuffixes{"a", "o", "obj", "lib", "so", "dll", "dylib"};
+    for (int i=0;i<arguments.count();i++) {
+        const QString& arg = arguments[i];
+        if (arg.startsWith("-L")) {
+            QString dir = (arg == "-L" && i+1<arguments.count()) ? arguments[++i] : arg.mid(2);
+            libDirs.append(QDir(workingDir).absoluteFilePath(dir));
+        } else if (arg.startsWith("-l")) {
+            libNames.append((arg == "-l" && i+1<arguments.count()) ? arguments[++i] : arg.mid(2));
+        } else if (!arg.startsWith("-") && inputSuffixes.contains(QFileInfo(arg).suffix().toLower())) {
+            inputFiles.append(QDir(workingDir).absoluteFilePath(arg));
+        }
+    }
+    //libraries are resolved the way the linker does, the first match wins
+    foreach (const QString& name, libNames) {
+        QStringList candidates;
+        if (name.startsWith(':'))
+            candidates << name.mid(1);
+        else
+            candidates << "lib" + name + ".dll.a" << "lib" + name + ".a" << "lib" + name + ".so"
+                       << "lib" + name + ".dylib" << name + ".lib";
+        bool found = false;
+        foreach (const QString& dir, libDirs) {
+            foreach (const QString& candidate, candidates) {
+                QString path = QDir(dir).absoluteFilePath(candidate);
+                if (fileExists(path)) {
+                    inputFiles.append(path);
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                break;
+        }
+        //libraries not found here are the compiler's own, covered by the compiler's fingerprint
+    }
+    QStringList result;
+    foreach (const QString& path, inputFiles) {
+        QFileInfo info(path);
+        result.append(QString("%1|%2|%3").arg(path)
+                      .arg(info.size())
+                      .arg(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return result;
+}
+
+void Compiler::runCommand(const QString &cmd, const QStringList &arguments, const QString &workingDir, const QByteArray& inputText, const QString& outputFile)
+{
+    if (mStop)
+        return;
+    QProcess process;
+    bool errorOccurred = false;
+    process.setProgram(cmd);
+    bool compilerErrorUTF8=compilerSet()->isCompilerInfoUsingUTF8();
+    bool outputUTF8=compilerSet()->forceUTF8();
+    process.setProcessEnvironment(getProcessEnvironment(cmd));
     process.setArguments(arguments);
     process.setWorkingDirectory(workingDir);
     QFile output;
@@ -787,8 +1119,14 @@ void Compiler::runCommand(const QString &cmd, const QStringList &arguments, cons
         if (process.state()!=QProcess::Running) {
             break;
         }
+        //deliver issues of a slow compiler in time
+        flushIssues();
         if (mStop) {
-            process.terminate();
+            //a cancelled syntax check is replaced by a newer one, don't wait for it
+            if (mOnlyCheckSyntax)
+                process.kill();
+            else
+                process.terminate();
         }
         if (errorOccurred)
             break;
@@ -869,17 +1207,302 @@ QStringList Compiler::getReflextiveArguments()
     return result;
 }
 
-void Compiler::log(const QString &msg)
+void Compiler::log(const QString &output)
 {
+    //make echoes the marker to stdout
+    QString msg = stripLinkPhaseMarker(output);
+    if (msg.isEmpty() && !output.isEmpty())
+        return;
     emit compileOutput(msg);
 }
 
-void Compiler::error(const QString &msg)
+void Compiler::addIssue(PCompileIssue issue)
+{
+    QMutexLocker locker(&mIssuesMutex);
+    if (mPendingIssues.isEmpty())
+        mIssueTimer.start();
+    mPendingIssues.append(issue);
+    if (mPendingIssues.count() < ISSUE_BATCH_SIZE
+            && mIssueTimer.elapsed() < ISSUE_BATCH_INTERVAL)
+        return;
+    emit compileIssues(mPendingIssues);
+    mPendingIssues.clear();
+}
+
+void Compiler::flushIssues()
+{
+    QMutexLocker locker(&mIssuesMutex);
+    if (mPendingIssues.isEmpty())
+        return;
+    emit compileIssues(mPendingIssues);
+    mPendingIssues.clear();
+}
+
+void Compiler::startLinkPhase()
+{
+    if (mLinkPhaseStart<0 && mBuildTimer.isValid())
+        mLinkPhaseStart = mBuildTimer.elapsed();
+}
+
+QString Compiler::stripLinkPhaseMarker(const QString &output)
+{
+    if (!output.contains(LINK_PHASE_MARKER))
+        return output;
+    //printed by the makefile right before linking
+    startLinkPhase();
+    QStringList lines = output.split('\n');
+    lines.erase(std::remove_if(lines.begin(), lines.end(),
+                               [](const QString& line){ return line.trimmed() == LINK_PHASE_MARKER; }),
+                lines.end());
+    return lines.join('\n');
+}
+
+void Compiler::error(const QString &output)
 {
-    if (msg != COMPILE_PROCESS_END)
+    QString msg = stripLinkPhaseMarker(output);
+    if (msg.isEmpty() && !output.isEmpty())
+        return;
+    if (mStructuredDiagnostics) {
+        if (msg != COMPILE_PROCESS_END)
+            mCompilerDiagnostics += msg;
+        processStructuredOutput(msg);
+        return;
+    }
+    if (msg != COMPILE_PROCESS_END) {
         emit compileOutput(msg);
+        mCompilerDiagnostics += msg;
+    }
     for (QString& s:msg.split("\n")) {
         if (!s.isEmpty())
             processOutput(s);
     }
 }
+
+QStringList Compiler::getStructuredDiagnosticsArguments()
+{
+    if (!compilerSet()
+            || (compilerSet()->compilerType() != CompilerType::GCC
+                && compilerSet()->compilerType() != CompilerType::GCC_UTF8))
+        return QStringList();
+    //gcc's json format is deprecated in favor of sarif since gcc 13
+    int version = compilerSet()->mainVersion();
+    if (version >= 13)
+        return QStringList{"-fdiagnostics-format=sarif-stderr"};
+    if (version >= 10)
+        return QStringList{"-fdiagnostics-format=json"};
+    return QStringList();
+}
+
+void Compiler::processStructuredOutput(const QString &msg)
+{
+    if (msg == COMPILE_PROCESS_END) {
+        if (!mPendingOutput.isEmpty()) {
+            //an unterminated json document is not diagnostics after all
+            processTextOutput(mPendingOutput);
+            mPendingOutput.clear();
+        }
+        mJsonDepth = 0;
+        mJsonInString = false;
+        mJsonEscaped = false;
+        QString line{COMPILE_PROCESS_END};
+        processOutput(line);
+        return;
+    }
+    //json documents are cut out by tracking bracket depth, everything else is plain text (linker errors etc.)
+    for (const QChar& ch : msg) {
+        if (mJsonDepth > 0) {
+            mPendingOutput += ch;
+            if (mJsonInString) {
+                if (mJsonEscaped)
+                    mJsonEscaped = false;
+                else if (ch == '\\')
+                    mJsonEscaped = true;
+                else if (ch == '"')
+                    mJsonInString = false;
+            } else if (ch == '"') {
+                mJsonInString = true;
+            } else if (ch == '[' || ch == '{') {
+                mJsonDepth++;
+            } else if (ch == ']' || ch == '}') {
+                mJsonDepth--;
+                if (mJsonDepth == 0) {
+                    processStructuredDiagnostics(mPendingOutput);
+                    mPendingOutput.clear();
+                }
+            }
+        } else if (ch == '\n') {
+            processTextOutput(mPendingOutput);
+            mPendingOutput.clear();
+        } else if (mPendingOutput.isEmpty() && (ch == '[' || ch == '{')) {
+            mJsonDepth = 1;
+            mPendingOutput += ch;
+        } else {
+            mPendingOutput += ch;
+        }
+    }
+}
+
+void Compiler::processTextOutput(const QString &text)
+{
+    emit compileOutput(text);
+    for (QString& s:text.split("\n")) {
+        if (!s.isEmpty())
+            processOutput(s);
+    }
+}
+
+void Compiler::processStructuredDiagnostics(const QString &text)
+{
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(text.toUtf8(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        processTextOutput(text);
+        return;
+    }
+    if (mLastIssue) {
+        addIssue(mLastIssue);
+        mLastIssue.reset();
+    }
+    mStructuredLog.clear();
+    if (doc.isArray()) {
+        foreach (const QJsonValue& value, doc.array())
+            processJsonDiagnostic(value.toObject());
+    } else {
+        foreach (const QJsonValue& run, doc.object()["runs"].toArray()) {
+            foreach (const QJsonValue& result, run.toObject()["results"].toArray())
+                processSarifResult(result.toObject());
+        }
+    }
+    //render the diagnostics like gcc does, all in one piece
+    if (!mStructuredLog.isEmpty())
+        emit compileOutput(mStructuredLog);
+    mStructuredLog.clear();
+}
+
+void Compiler::processJsonDiagnostic(const QJsonObject &diagnostic)
+{
+    PCompileIssue issue = std::make_shared<CompileIssue>();
+    issue->line = 0;
+    issue->column = -1;
+    issue->endColumn = -1;
+    QJsonArray locations = diagnostic["locations"].toArray();
+    if (!locations.isEmpty()) {
+        QJsonObject location = locations[0].toObject();
+        QJsonObject caret = location["caret"].toObject();
+        issue->filename = getFileNameFromDiagnostic(caret["file"].toString());
+        issue->line = caret["line"].toInt();
+        issue->column = caret.contains("display-column") ? caret["display-column"].toInt() : caret["column"].toInt();
+        if (location.contains("finish")) {
+            QJsonObject finish = location["finish"].toObject();
+            if (finish["line"].toInt() == issue->line) {
+                int finishColumn = finish.contains("display-column") ? finish["display-column"].toInt() : finish["column"].toInt();
+                issue->endColumn = finishColumn + 1;
+            }
+        }
+    }
+    QStringList fixIts;
+    foreach (const QJsonValue& fixIt, diagnostic["fixits"].toArray())
+        fixIts.append(fixIt.toObject()["string"].toString());
+    emitStructuredIssue(issue, diagnostic["kind"].toString(), diagnostic["message"].toString(),
+            diagnostic["option"].toString(), fixIts);
+    foreach (const QJsonValue& child, diagnostic["children"].toArray())
+        processJsonDiagnostic(child.toObject());
+}
+
+void Compiler::processSarifResult(const QJsonObject &result)
+{
+    QString level = result["level"].toString("warning");
+    QString message = result["message"].toObject()["text"].toString();
+    QString ruleId = result["ruleId"].toString();
+    //sarif has no rule for plain errors, gcc uses the level as rule id
+    if (!ruleId.startsWith("-W"))
+        ruleId.clear();
+    QStringList fixIts;
+    foreach (const QJsonValue& fix, result["fixes"].toArray()) {
+        foreach (const QJsonValue& change, fix.toObject()["artifactChanges"].toArray()) {
+            foreach (const QJsonValue& replacement, change.toObject()["replacements"].toArray())
+                fixIts.append(replacement.toObject()["insertedContent"].toObject()["text"].toString());
+        }
+    }
+    QJsonArray locations = result["locations"].toArray();
+    processSarifLocation(locations.isEmpty() ? QJsonObject() : locations[0].toObject(),
+                         level, message, ruleId, fixIts);
+    //notes and include chains
+    foreach (const QJsonValue& value, result["relatedLocations"].toArray()) {
+        QJsonObject location = value.toObject();
+        processSarifLocation(location, "note", location["message"].toObject()["text"].toString(),
+                QString(), QStringList());
+    }
+}
+
+void Compiler::processSarifLocation(const QJsonObject &location, const QString &level, const QString &message, const QString &ruleId, const QStringList &fixIts)
+{
+    PCompileIssue issue = std::make_shared<CompileIssue>();
+    issue->line = 0;
+    issue->column = -1;
+    issue->endColumn = -1;
+    QJsonObject physicalLocation = location["physicalLocation"].toObject();
+    if (!physicalLocation.isEmpty()) {
+        QString uri = physicalLocation["artifactLocation"].toObject()["uri"].toString();
+        if (uri.startsWith("file:"))
+            uri = QUrl(uri).toLocalFile();
+        issue->filename = getFileNameFromDiagnostic(uri);
+        QJsonObject region = physicalLocation["region"].toObject();
+        issue->line = region["startLine"].toInt();
+        issue->column = region["startColumn"].toInt(-1);
+        if (region.contains("endColumn") && region["endLine"].toInt(issue->line) == issue->line)
+            issue->endColumn = region["endColumn"].toInt();
+    }
+    emitStructuredIssue(issue, level, message, ruleId, fixIts);
+}
+
+void Compiler::emitStructuredIssue(PCompileIssue issue, const QString &kind, const QString &message, const QString &option, const QStringList &fixIts)
+{
+    QString prefix;
+    if (kind == "error" || kind == "fatal error" || kind.startsWith("sorry")) {
+        mErrorCount += 1;
+        prefix = tr("[Error] ");
+        issue->type = CompileIssueType::Error;
+    } else if (kind == "warning" || kind == "pedwarn") {
+        mWarningCount += 1;
+        prefix = tr("[Warning] ");
+        issue->type = CompileIssueType::Warning;
+    } else if (kind == "note") {
+        mWarningCount += 1;
+        prefix = tr("[Note] ");
+        issue->type = CompileIssueType::Note;
+    } else {
+        issue->type = CompileIssueType::Other;
+    }
+    QString description = message;
+    if (!option.isEmpty())
+        description += QString(" [%1]").arg(option);
+    foreach (const QString& fixIt, fixIts) {
+        if (!fixIt.isEmpty())
+            description += QString(" (fix-it: \"%1\")").arg(fixIt);
+    }
+    issue->description = prefix + description;
+
+    if (!mStructuredLog.isEmpty())
+        mStructuredLog += '\n';
+    if (issue->line > 0)
+        mStructuredLog += QString("%1:%2:%3: %4: %5").arg(issue->filename).arg(issue->line).arg(issue->column).arg(kind, description);
+    else if (!issue->filename.isEmpty())
+        mStructuredLog += QString("%1: %2: %3").arg(issue->filename, kind, description);
+    else
+        mStructuredLog += QString("%1: %2").arg(kind, description);
+    addIssue(issue);
+}
+
+QString Compiler::getFileNameFromDiagnostic(const QString &filename)
+{
+    if (filename.isEmpty())
+        return filename;
+    if (filename.compare("<stdin>", Qt::CaseInsensitive)==0)
+        return mFilename;
+    if (!mDirectory.isEmpty()) {
+        QFileInfo info(filename);
+        return info.isRelative()?generateAbsolutePath(mDirectory,filename):cleanPath(filename);
+    }
+    return filename;
+}
@@ -18,9 +18,18 @@
 #define COMPILER_H
 
 #include <QThread>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QProcessEnvironment>
+#include <atomic>
 #include "settings.h"
 #include "../common.h"
 #include "../parser/cppparser.h"
+#include "objectcache.h"
+
+#define COMPILE_PROCESS_END "---//END//----"
+#define LINK_PHASE_MARKER "---//LINK//----"
 
 class Project;
 class Compiler : public QThread
@@ -50,7 +59,7 @@ signals:
     void compileStarted();
     void compileFinished(QString filename);
     void compileOutput(const QString& msg);
-    void compileIssue(PCompileIssue issue);
+    void compileIssues(QList<PCompileIssue> issues);
     void compileErrorOccured(const QString& reason);
 public slots:
     void stopCompile();
@@ -70,6 +79,9 @@ protected:
     virtual QByteArray pipedText();
     virtual bool prepareForRebuild() = 0;
     virtual bool beforeRunExtraCommand(int idx);
+    virtual void runMainCommand();
+    virtual bool fetchOutputFromCache();
+    virtual void storeOutputToCache();
     virtual QStringList getCharsetArgument(const QByteArray& encoding, FileType fileType, bool onlyCheckSyntax);
     virtual QStringList getCCompileArguments(bool checkSyntax);
     virtual QStringList getCppCompileArguments(bool checkSyntax);
@@ -84,9 +96,21 @@ protected:
             const QString& filename,
             QSet<QString>& parsedFiles);
     virtual QStringList getReflextiveArguments();
-    void log(const QString& msg);
-    void error(const QString& msg);
+    void log(const QString& output);
+    void error(const QString& output);
+    void addIssue(PCompileIssue issue);
+    void flushIssues();
+    void startLinkPhase();
+    QString stripLinkPhaseMarker(const QString& output);
     void runCommand(const QString& cmd, const QStringList& arguments, const QString& workingDir, const QByteArray& inputText=QByteArray(), const QString& outputFile=QString());
+    QProcessEnvironment getProcessEnvironment(const QString& cmd);
+    QStringList getPrecompiledHeaderArguments(bool isCpp, const QStringList& arguments, const QString& content);
+    QStringList getStructuredDiagnosticsArguments();
+    PObjectCache createObjectCache();
+    QByteArray computeObjectCacheKey(const QString& compiler, const QString& sourceFile,
+                                     const QStringList& flags, const QStringList& keyArguments,
+                                     const QString& workingDir);
+    QStringList getLinkInputsFingerprint(const QStringList& arguments, const QString& workingDir);
     QString escapeCommandForLog(const QString &cmd, const QStringList &arguments);
 
 protected:
@@ -107,9 +131,39 @@ protected:
     bool mSetLANG;
     PCppParser mParserForFile;
     bool mForceEnglishOutput;
+    PObjectCache mObjectCache;
+    QString mCompilerDiagnostics;
+    std::atomic_bool mStop;
+    bool mStructuredDiagnostics;
 
 private:
-    bool mStop;
+    bool buildPrecompiledHeader(const QString& language, const QStringList& arguments,
+                                const QString& header, const QString& pchFile);
+    void releasePrecompiledHeader();
+    void prunePrecompiledHeaders(const QString& baseDir, const QString& keptDir);
+    void processStructuredOutput(const QString& msg);
+    void processTextOutput(const QString& text);
+    void processStructuredDiagnostics(const QString& text);
+    void processJsonDiagnostic(const QJsonObject& diagnostic);
+    void processSarifResult(const QJsonObject& result);
+    void processSarifLocation(const QJsonObject& location, const QString& level, const QString& message,
+                              const QString& ruleId, const QStringList& fixIts);
+    void emitStructuredIssue(PCompileIssue issue, const QString& kind, const QString& message,
+                             const QString& option, const QStringList& fixIts);
+    QString getFileNameFromDiagnostic(const QString& filename);
+private:
+    QElapsedTimer mBuildTimer;
+    qint64 mLinkPhaseStart;
+    //directory of the precompiled header used by this compile
+    QString mPrecompiledHeaderDir;
+    QList<PCompileIssue> mPendingIssues;
+    QElapsedTimer mIssueTimer;
+    QMutex mIssuesMutex;
+    QString mPendingOutput;
+    QString mStructuredLog;
+    int mJsonDepth;
+    bool mJsonInString;
+    bool mJsonEscaped;
 };
 
 
@@ -32,6 +32,11 @@ bool CompilerInfo::supportSyntaxCheck()
     return true;
 }
 
+bool CompilerInfo::supportPrecompiledHeader()
+{
+    return true;
+}
+
 PCompilerOption CompilerInfo::addOption(const QString &key, const QString &name,
                              const QString section, bool isC, bool isCpp, bool isLinker, const QString &setting,
                              CompilerOptionType type, const CompileOptionChoiceList &choices)
@@ -302,6 +307,14 @@ bool CompilerInfoManager::supportSyntaxCheck(CompilerType compilerType)
     return pInfo->supportSyntaxCheck();
 }
 
+bool CompilerInfoManager::supportPrecompiledHeader(CompilerType compilerType)
+{
+    PCompilerInfo pInfo = getInfo(compilerType);
+    if (!pInfo)
+        return false;
+    return pInfo->supportPrecompiledHeader();
+}
+
 bool CompilerInfoManager::forceUTF8InDebugger(CompilerType compilerType)
 {
     PCompilerInfo pInfo = getInfo(compilerType);
@@ -428,6 +441,11 @@ bool SDCCCompilerInfo::supportSyntaxCheck()
     return false;
 }
 
+bool SDCCCompilerInfo::supportPrecompiledHeader()
+{
+    return false;
+}
+
 void SDCCCompilerInfo::prepareCompilerOptions()
 {
     QList<QPair<QString,QString>> sl;
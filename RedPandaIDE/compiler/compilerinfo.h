@@ -131,6 +131,7 @@ public:
     virtual bool forceUTF8InMakefile()=0;
     virtual bool supportStaticLink()=0;
     virtual bool supportSyntaxCheck();
+    virtual bool supportPrecompiledHeader();
 protected:
     PCompilerOption addOption(const QString& key,
                    const QString& name,
@@ -176,6 +177,7 @@ public:
     static bool supportCovertingCharset(CompilerType compilerType);
     static bool supportStaticLink(CompilerType compilerType);
     static bool supportSyntaxCheck(CompilerType compilerType);
+    static bool supportPrecompiledHeader(CompilerType compilerType);
     static bool forceUTF8InDebugger(CompilerType compilerType);
     static PCompilerInfoManager getInstance();
     static void addInfo(CompilerType compilerType, PCompilerInfo info);
@@ -220,6 +222,7 @@ public:
     bool forceUTF8InMakefile() override;
     bool supportStaticLink() override;
     bool supportSyntaxCheck() override;
+    bool supportPrecompiledHeader() override;
 protected:
     void prepareCompilerOptions() override;
 };
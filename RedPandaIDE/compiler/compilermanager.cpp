@@ -25,6 +25,7 @@
 #include "../mainwindow.h"
 #include "executablerunner.h"
 #include "ojproblemcasesrunner.h"
+#include "ojstresstestrunner.h"
 #include "utils.h"
 #include "utils/parsearg.h"
 #include "../systemconsts.h"
@@ -32,23 +33,26 @@
 #include <QMessageBox>
 #include <QUuid>
 #include "projectcompiler.h"
+#include "nativeprojectcompiler.h"
 #ifdef Q_OS_MACOS
 #include <sys/posix_shm.h>
 #endif
 
+//wait this long for more edits before starting a syntax check
+#define SYNTAX_CHECK_DEBOUNCE_INTERVAL 300
+
 CompilerManager::CompilerManager(QObject *parent) : QObject(parent),
     mCompileMutex(),
     mBackgroundSyntaxCheckMutex(),
     mRunnerMutex()
 {
     mCompiler = nullptr;
-    mBackgroundSyntaxChecker = nullptr;
     mRunner = nullptr;
-    mSyntaxCheckErrorCount = 0;
-    mSyntaxCheckIssueCount = 0;
     mCompileErrorCount = 0;
     mCompileIssueCount = 0;
-    mSyntaxCheckErrorCount = 0;
+    mSyntaxCheckTimer.setSingleShot(true);
+    mSyntaxCheckTimer.setInterval(SYNTAX_CHECK_DEBOUNCE_INTERVAL);
+    connect(&mSyntaxCheckTimer, &QTimer::timeout, this, &CompilerManager::startPendingSyntaxChecks);
 }
 
 bool CompilerManager::compiling()
@@ -60,7 +64,7 @@ bool CompilerManager::compiling()
 bool CompilerManager::backgroundSyntaxChecking()
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-    return mBackgroundSyntaxChecker!=nullptr;
+    return !mBackgroundSyntaxCheckers.isEmpty() || !mPendingSyntaxCheckFiles.isEmpty();
 }
 
 bool CompilerManager::running()
@@ -94,12 +98,12 @@ void CompilerManager::compile(const QString& filename, const QByteArray& encodin
         mCompiler->setRebuild(rebuild);
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::onCompileStarted);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::clearToolsOutput);
 
         connect(mCompiler, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
-        connect(mCompiler, &Compiler::compileIssue, pMainWindow, &MainWindow::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, pMainWindow, &MainWindow::onCompileIssues);
         connect(mCompiler, &Compiler::compileErrorOccured, pMainWindow, &MainWindow::onCompileErrorOccured);
         mCompiler->start();
     }
@@ -126,12 +130,12 @@ void CompilerManager::compileProject(std::shared_ptr<Project> project, bool rebu
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
 
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::onProjectCompileStarted);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::clearToolsOutput);
 
         connect(mCompiler, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
-        connect(mCompiler, &Compiler::compileIssue, pMainWindow, &MainWindow::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, pMainWindow, &MainWindow::onCompileIssues);
         connect(mCompiler, &Compiler::compileErrorOccured, pMainWindow, &MainWindow::onCompileErrorOccured);
         mCompiler->start();
     }
@@ -160,12 +164,12 @@ void CompilerManager::cleanProject(std::shared_ptr<Project> project)
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
 
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::onProjectCompileStarted);
         connect(mCompiler, &Compiler::compileStarted, pMainWindow, &MainWindow::clearToolsOutput);
 
         connect(mCompiler, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
-        connect(mCompiler, &Compiler::compileIssue, pMainWindow, &MainWindow::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, pMainWindow, &MainWindow::onCompileIssues);
         connect(mCompiler, &Compiler::compileErrorOccured, pMainWindow, &MainWindow::onCompileErrorOccured);
         mCompiler->start();
     }
@@ -198,29 +202,83 @@ void CompilerManager::checkSyntax(const QString &filename, const QByteArray& enc
                               tr("No compiler set is configured.")+tr("Can't start debugging."));
         return;
     }
-    {
-        QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-        if (mBackgroundSyntaxChecker!=nullptr) {
-            return;
-        }
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
 
-        mSyntaxCheckErrorCount = 0;
-        mSyntaxCheckIssueCount = 0;
+    //the running check works on outdated content, kill it
+    Compiler* checker = mBackgroundSyntaxCheckers.value(filename,nullptr);
+    if (checker)
+        cancelSyntaxCheck(checker);
+
+    PSyntaxCheckRequest request = std::make_shared<SyntaxCheckRequest>();
+    request->filename = filename;
+    request->encoding = encoding;
+    request->content = content;
+    request->project = project;
+    mPendingSyntaxChecks.insert(filename, request);
+    mPendingSyntaxCheckFiles.removeOne(filename);
+    mPendingSyntaxCheckFiles.append(filename);
+    mSyntaxCheckTimer.start();
+}
 
-        //deleted when thread finished
-        mBackgroundSyntaxChecker = new StdinCompiler(filename,encoding, content,true);
-        mBackgroundSyntaxChecker->setProject(project);
-        connect(mBackgroundSyntaxChecker, &Compiler::finished, mBackgroundSyntaxChecker, &QThread::deleteLater);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileIssue, this, &CompilerManager::onSyntaxCheckIssue);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileStarted, pMainWindow, &MainWindow::onSyntaxCheckStarted);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileFinished, this, &CompilerManager::onSyntaxCheckFinished);
-        //connect(mBackgroundSyntaxChecker, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileIssue, pMainWindow, &MainWindow::onCompileIssue);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileErrorOccured, pMainWindow, &MainWindow::onCompileErrorOccured);
-        mBackgroundSyntaxChecker->start();
+void CompilerManager::startPendingSyntaxChecks()
+{
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    //leave the rest of the cores to the parser and the ui
+    int budget = std::max(1, QThread::idealThreadCount() / 2);
+    while (!mPendingSyntaxCheckFiles.isEmpty()
+           && mBackgroundSyntaxCheckers.count() < budget) {
+        QString filename = mPendingSyntaxCheckFiles.takeFirst();
+        PSyntaxCheckRequest request = mPendingSyntaxChecks.take(filename);
+        startSyntaxCheck(request);
     }
 }
 
+void CompilerManager::startSyntaxCheck(const PSyntaxCheckRequest &request)
+{
+    //deleted when thread finished
+    Compiler* checker = new StdinCompiler(request->filename,request->encoding, request->content,true);
+    checker->setProject(request->project);
+    mBackgroundSyntaxCheckers.insert(request->filename, checker);
+    connect(checker, &Compiler::finished, checker, &QThread::deleteLater);
+    connect(checker, &Compiler::compileIssues, this,
+            [this,checker](QList<PCompileIssue> issues){
+        onSyntaxCheckIssues(checker, issues);
+    });
+    QString filename = request->filename;
+    connect(checker, &Compiler::compileStarted, this,
+            [this,checker,filename](){
+        QList<PCompileIssue> staleIssues;
+        {
+            QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+            if (mCancelledSyntaxCheckers.contains(checker))
+                return;
+            //only the issues of the last check of this file are replaced
+            staleIssues = mSyntaxCheckIssues.take(filename);
+        }
+        pMainWindow->onSyntaxCheckStarted(staleIssues);
+    });
+    connect(checker, &Compiler::compileFinished, this,
+            [this,checker](QString filename){
+        onSyntaxCheckFinished(checker, filename);
+    });
+    //connect(checker, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
+    connect(checker, &Compiler::compileErrorOccured, this,
+            [this,checker](const QString& reason){
+        QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+        if (!mCancelledSyntaxCheckers.contains(checker))
+            pMainWindow->onCompileErrorOccured(reason);
+    });
+    checker->start();
+}
+
+void CompilerManager::cancelSyntaxCheck(Compiler *checker)
+{
+    //results already queued by the checker are dropped when they arrive
+    mBackgroundSyntaxCheckers.remove(mBackgroundSyntaxCheckers.key(checker));
+    mCancelledSyntaxCheckers.insert(checker);
+    checker->stopCompile();
+}
+
 void CompilerManager::run(
         const QString &filename,
         const QString &arguments,
@@ -337,6 +395,7 @@ void CompilerManager::run(
 
     mRunner = execRunner;
 
+    connect(execRunner, &ExecutableRunner::runStatisticsReady, pMainWindow ,&MainWindow::onRunStatisticsReady);
     connect(mRunner, &Runner::finished, this ,&CompilerManager::onRunnerTerminated);
     connect(mRunner, &Runner::finished, mRunner ,&Runner::deleteLater);
     connect(mRunner, &Runner::finished, pMainWindow ,&MainWindow::onRunFinished);
@@ -381,6 +440,12 @@ void CompilerManager::doRunProblem(const QString &filename, const QString &argum
         execRunner->setExecTimeout(timeLimit);
     if (memoryLimit)
         execRunner->setMemoryLimit(memoryLimit);
+    if (pSettings->executor().runCasesInParallel()) {
+        int jobs = pSettings->executor().parallelCaseJobs();
+        if (jobs <= 0)
+            jobs = std::max(1, physicalCoreCount() - 1);
+        execRunner->setJobs(jobs);
+    }
     connect(mRunner, &Runner::finished, this ,&CompilerManager::onRunnerTerminated);
     connect(mRunner, &Runner::finished, mRunner ,&Runner::deleteLater);
     connect(mRunner, &Runner::finished, pMainWindow ,&MainWindow::onRunProblemFinished);
@@ -395,6 +460,97 @@ void CompilerManager::doRunProblem(const QString &filename, const QString &argum
     mRunner->start();
 }
 
+void CompilerManager::runStressTest(const QString &answerSource, const QString &generatorSource,
+                                    const QString &bruteForceSource, const POJProblem &problem)
+{
+    QMutexLocker locker(&mRunnerMutex);
+    if (mRunner!=nullptr) {
+        return;
+    }
+    Settings::PCompilerSet compilerSet = pSettings->compilerSets().defaultSet();
+    if (!compilerSet) {
+        QMessageBox::critical(pMainWindow,
+                              tr("No compiler set"),
+                              tr("No compiler set is configured."));
+        return;
+    }
+    QStringList sources{generatorSource, bruteForceSource, answerSource};
+    QStringList executables;
+    //compile only when the executable is older than the source
+    QStringList outdatedSources;
+    QStringList outdatedExecutables;
+    foreach (const QString& source, sources) {
+        QString executable = compilerSet->getOutputFilename(source);
+        executables.append(executable);
+        if (!fileExists(executable) || compareFileModifiedTime(source, executable) >= 0) {
+            outdatedSources.append(source);
+            outdatedExecutables.append(executable);
+        }
+    }
+    OJStressTestRunner * execRunner = new OJStressTestRunner(executables[2], executables[0], executables[1],
+                                                             extractFileDir(answerSource));
+    mRunner = execRunner;
+    if (pSettings->executor().enableCaseLimit())
+        execRunner->setExecTimeout(pSettings->executor().caseTimeout());
+    if (problem->getTimeLimit()>0)
+        execRunner->setExecTimeout(problem->getTimeLimit());
+    int jobs = pSettings->executor().parallelCaseJobs();
+    if (jobs <= 0)
+        jobs = std::max(1, physicalCoreCount() - 1);
+    execRunner->setJobs(jobs);
+    execRunner->setValidateType(pSettings->executor().problemCaseValidateType());
+    connect(mRunner, &Runner::finished, this ,&CompilerManager::onRunnerTerminated);
+    connect(mRunner, &Runner::finished, mRunner ,&Runner::deleteLater);
+    connect(mRunner, &Runner::finished, pMainWindow ,&MainWindow::onRunProblemFinished);
+    connect(mRunner, &Runner::runErrorOccurred, pMainWindow ,&MainWindow::onRunErrorOccured);
+    connect(execRunner, &OJStressTestRunner::logOutput, pMainWindow, &MainWindow::logToolsOutput);
+    connect(execRunner, &OJStressTestRunner::progressUpdated, pMainWindow, &MainWindow::onStressTestProgressUpdated);
+    connect(execRunner, &OJStressTestRunner::mismatchFound, pMainWindow, &MainWindow::onStressTestMismatchFound);
+    buildStressTestPrograms(execRunner, outdatedSources, outdatedExecutables);
+}
+
+void CompilerManager::buildStressTestPrograms(OJStressTestRunner *runner, QStringList sources, QStringList executables)
+{
+    {
+        QMutexLocker locker(&mRunnerMutex);
+        //stopped while compiling, the runner was never started
+        if (mRunner != runner) {
+            runner->deleteLater();
+            return;
+        }
+        if (sources.isEmpty()) {
+            runner->start();
+            return;
+        }
+    }
+    QString source = sources.takeFirst();
+    QString executable = executables.takeFirst();
+    pMainWindow->logToolsOutput(tr("Compiling %1...").arg(source));
+    //compilers look up the opened editors, so they are created in the gui thread
+    Compiler* compiler = new FileCompiler(source, ENCODING_AUTO_DETECT, CppCompileType::Normal, false);
+    connect(compiler, &Compiler::finished, compiler, &QObject::deleteLater);
+    connect(compiler, &Compiler::compileOutput, pMainWindow, &MainWindow::logToolsOutput);
+    connect(compiler, &Compiler::compileErrorOccured, pMainWindow, &MainWindow::logToolsOutput);
+    connect(compiler, &Compiler::finished, this,
+            [this, runner, source, executable, sources, executables](){
+        if (fileExists(executable) && compareFileModifiedTime(source, executable) < 0) {
+            buildStressTestPrograms(runner, sources, executables);
+            return;
+        }
+        bool stopped;
+        {
+            QMutexLocker locker(&mRunnerMutex);
+            stopped = (mRunner != runner);
+        }
+        if (!stopped) {
+            pMainWindow->onRunErrorOccured(tr("Failed to compile '%1'.").arg(source));
+            pMainWindow->onRunProblemFinished();
+        }
+        runner->deleteLater();
+    });
+    compiler->start();
+}
+
 void CompilerManager::stopRun()
 {
     QMutexLocker locker(&mRunnerMutex);
@@ -432,8 +588,12 @@ void CompilerManager::stopCompile()
 void CompilerManager::stopCheckSyntax()
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-    if (mBackgroundSyntaxChecker!=nullptr)
-        mBackgroundSyntaxChecker->stopCompile();
+    mSyntaxCheckTimer.stop();
+    mPendingSyntaxChecks.clear();
+    mPendingSyntaxCheckFiles.clear();
+    foreach (Compiler* checker, mBackgroundSyntaxCheckers.values()) {
+        cancelSyntaxCheck(checker);
+    }
 }
 
 bool CompilerManager::canCompile(const QString &)
@@ -466,27 +626,37 @@ void CompilerManager::onRunnerPausing()
     mTempFileOwner=nullptr;
 }
 
-void CompilerManager::onCompileIssue(PCompileIssue issue)
+void CompilerManager::onCompileIssues(QList<PCompileIssue> issues)
 {
-    if (issue->type == CompileIssueType::Error)
-        mCompileErrorCount++;
-    mCompileIssueCount++;
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->type == CompileIssueType::Error)
+            mCompileErrorCount++;
+    }
+    mCompileIssueCount += issues.count();
 }
 
-void CompilerManager::onSyntaxCheckFinished(QString filename)
+void CompilerManager::onSyntaxCheckFinished(Compiler* checker, const QString& filename)
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-    mBackgroundSyntaxChecker=nullptr;
+    if (mCancelledSyntaxCheckers.remove(checker)) {
+        startPendingSyntaxChecks();
+        return;
+    }
+    mBackgroundSyntaxCheckers.remove(filename);
+    startPendingSyntaxChecks();
     pMainWindow->onCompileFinished(filename, true);
 }
 
-void CompilerManager::onSyntaxCheckIssue(PCompileIssue issue)
+void CompilerManager::onSyntaxCheckIssues(Compiler* checker, QList<PCompileIssue> issues)
 {
-    if (issue->type == CompileIssueType::Error)
-        mSyntaxCheckErrorCount++;
-    if (issue->type == CompileIssueType::Error ||
-            issue->type == CompileIssueType::Warning)
-        mSyntaxCheckIssueCount++;
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    if (mCancelledSyntaxCheckers.contains(checker))
+        return;
+    QString filename = mBackgroundSyntaxCheckers.key(checker);
+    if (filename.isEmpty())
+        return;
+    mSyntaxCheckIssues[filename].append(issues);
+    pMainWindow->onCompileIssues(issues);
 }
 
 ProjectCompiler *CompilerManager::createProjectCompiler(std::shared_ptr<Project> project)
@@ -494,14 +664,30 @@ ProjectCompiler *CompilerManager::createProjectCompiler(std::shared_ptr<Project>
 #ifdef ENABLE_SDCC
     if (project->options().type==ProjectType::MicroController)
         return new SDCCProjectCompiler(project);
-    else
 #endif
-        return new ProjectCompiler(project);
+    if (project->options().useNativeBuilder
+            && NativeProjectCompiler::supportsProject(project))
+        return new NativeProjectCompiler(project);
+    return new ProjectCompiler(project);
 }
 
 int CompilerManager::syntaxCheckIssueCount() const
 {
-    return mSyntaxCheckIssueCount;
+    int count = 0;
+    foreach (const QList<PCompileIssue>& issues, mSyntaxCheckIssues) {
+        foreach (const PCompileIssue& issue, issues) {
+            if (issue->type == CompileIssueType::Error ||
+                    issue->type == CompileIssueType::Warning)
+                count++;
+        }
+    }
+    return count;
+}
+
+void CompilerManager::clearSyntaxCheckIssues()
+{
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    mSyntaxCheckIssues.clear();
 }
 
 int CompilerManager::compileIssueCount() const
@@ -511,7 +697,14 @@ int CompilerManager::compileIssueCount() const
 
 int CompilerManager::syntaxCheckErrorCount() const
 {
-    return mSyntaxCheckErrorCount;
+    int count = 0;
+    foreach (const QList<PCompileIssue>& issues, mSyntaxCheckIssues) {
+        foreach (const PCompileIssue& issue, issues) {
+            if (issue->type == CompileIssueType::Error)
+                count++;
+        }
+    }
+    return count;
 }
 
 int CompilerManager::compileErrorCount() const
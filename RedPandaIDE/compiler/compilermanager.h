@@ -19,6 +19,9 @@
 
 #include <QObject>
 #include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 #include "qt_utils/utils.h"
 #include "../utils.h"
 #include "../common.h"
@@ -26,10 +29,19 @@
 enum RunProgramFlag {
     RPF_PAUSE_CONSOLE =     0x0001,
     RPF_REDIRECT_INPUT =    0x0002,
-    RPF_ENABLE_VIRTUAL_TERMINAL_PROCESSING = 0x0004
+    RPF_ENABLE_VIRTUAL_TERMINAL_PROCESSING = 0x0004,
+    RPF_REPORT_USAGE =      0x0008
 };
 
+//layout of the memory page shared with consolepauser
+#define CONSOLE_PAUSER_SHM_SIZE 1024
+//statistics of the finished program, written by consolepauser before it sets "FINISHED" at the start (unix only)
+#define CONSOLE_PAUSER_SHM_USAGE_OFFSET 16
+//a zero terminated path of the fifo that consolepauser writes a byte to when its state changes (unix only)
+#define CONSOLE_PAUSER_SHM_NOTIFY_PATH_OFFSET 512
+
 class Runner;
+class OJStressTestRunner;
 class Project;
 class Compiler;
 class ProjectCompiler;
@@ -37,6 +49,15 @@ struct OJProblem;
 using POJProblem = std::shared_ptr<OJProblem>;
 struct OJProblemCase;
 using POJProblemCase = std::shared_ptr<OJProblemCase>;
+
+struct SyntaxCheckRequest {
+    QString filename;
+    QByteArray encoding;
+    QString content;
+    std::shared_ptr<Project> project;
+};
+using PSyntaxCheckRequest = std::shared_ptr<SyntaxCheckRequest>;
+
 class CompilerManager : public QObject
 {
     Q_OBJECT
@@ -66,6 +87,8 @@ public:
     void runProblem(const QString& filename, const QString& arguments, const QString& workDir, const QVector<POJProblemCase> &problemCases,
                     const POJProblem& problem
                     );
+    void runStressTest(const QString& answerSource, const QString& generatorSource,
+                       const QString& bruteForceSource, const POJProblem& problem);
     void stopRun();
     void stopAllRunners();
     void stopPausing();
@@ -79,6 +102,8 @@ public:
     int compileIssueCount() const;
 
     int syntaxCheckIssueCount() const;
+    // forget the issues of all syntax checks, after the issues table is cleared
+    void clearSyntaxCheckIssues();
 
 signals:
     void signalStopAllRunners();
@@ -90,18 +115,29 @@ private slots:
     void onRunnerTerminated();
     void onRunnerPausing();
     void onCompileFinished(QString filename);
-    void onCompileIssue(PCompileIssue issue);
-    void onSyntaxCheckFinished(QString filename);
-    void onSyntaxCheckIssue(PCompileIssue issue);
+    void onCompileIssues(QList<PCompileIssue> issues);
+    void onSyntaxCheckFinished(Compiler* checker, const QString& filename);
+    void onSyntaxCheckIssues(Compiler* checker, QList<PCompileIssue> issues);
+    void startPendingSyntaxChecks();
 private:
     ProjectCompiler* createProjectCompiler(std::shared_ptr<Project> project);
+    void startSyntaxCheck(const PSyntaxCheckRequest& request);
+    void cancelSyntaxCheck(Compiler* checker);
+    void buildStressTestPrograms(OJStressTestRunner* runner, QStringList sources, QStringList executables);
 private:
     Compiler* mCompiler;
     int mCompileErrorCount;
     int mCompileIssueCount;
-    int mSyntaxCheckErrorCount;
-    int mSyntaxCheckIssueCount;
-    Compiler* mBackgroundSyntaxChecker;
+    //issues found by the last check of each file, so they can be replaced by the next check
+    QHash<QString,QList<PCompileIssue>> mSyntaxCheckIssues;
+    //running syntax checks, at most one per file
+    QHash<QString,Compiler*> mBackgroundSyntaxCheckers;
+    //killed checks whose results must be dropped
+    QSet<Compiler*> mCancelledSyntaxCheckers;
+    //latest content waiting for each file, in request order
+    QHash<QString,PSyntaxCheckRequest> mPendingSyntaxChecks;
+    QStringList mPendingSyntaxCheckFiles;
+    QTimer mSyntaxCheckTimer;
     Runner* mRunner;
     PNonExclusiveTemporaryFileOwner mTempFileOwner;
     QRecursiveMutex mCompileMutex;
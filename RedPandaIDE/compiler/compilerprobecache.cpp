@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "compilerprobecache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "qt_utils/utils.h"
+#include "../settings.h"
+
+#define PROBE_CACHE_VERSION 1
+
+CompilerProbeCache::CompilerProbeCache(const QString &dir):
+    mDir{dir}
+{
+}
+
+bool CompilerProbeCache::fetch(const QString &binFile, const QString &workingDir,
+                               const QStringList &arguments, QByteArray &output)
+{
+    QMutexLocker locker(&mMutex);
+    PEntry entry = getEntry(binFile);
+    if (!entry)
+        return false;
+    auto it = entry->outputs.constFind(probeKey(workingDir, arguments));
+    if (it == entry->outputs.constEnd())
+        return false;
+    output = it.value();
+    return true;
+}
+
+void CompilerProbeCache::store(const QString &binFile, const QString &workingDir,
+                               const QStringList &arguments, const QByteArray &output)
+{
+    QMutexLocker locker(&mMutex);
+    PEntry entry = getEntry(binFile);
+    if (!entry)
+        return;
+    entry->outputs.insert(probeKey(workingDir, arguments), output);
+    saveEntry(entry);
+}
+
+void CompilerProbeCache::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mEntries.clear();
+    QDir dir(mDir);
+    if (dir.exists())
+        dir.removeRecursively();
+}
+
+CompilerProbeCache *CompilerProbeCache::instance()
+{
+    static CompilerProbeCache cache(
+                includeTrailingPathDelimiter(pSettings->dirs().cache())+"compilers");
+    return &cache;
+}
+
+CompilerProbeCache::PEntry CompilerProbeCache::getEntry(const QString &binFile)
+{
+    QFileInfo info(binFile);
+    if (!info.exists())
+        return PEntry();
+    QString path = info.canonicalFilePath();
+    qint64 size = info.size();
+    qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+    PEntry entry = mEntries.value(path);
+    if (!entry)
+        entry = loadEntry(path);
+    if (!entry || entry->size != size || entry->lastModified != lastModified) {
+        //binary changed, all probed results are stale
+        entry = std::make_shared<Entry>();
+        entry->path = path;
+        entry->size = size;
+        entry->lastModified = lastModified;
+        QFile::remove(entryPath(path));
+    }
+    mEntries.insert(path, entry);
+    return entry;
+}
+
+CompilerProbeCache::PEntry CompilerProbeCache::loadEntry(const QString &path)
+{
+    QFile file(entryPath(path));
+    if (!file.open(QFile::ReadOnly))
+        return PEntry();
+    QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+    if (obj["version"].toInt() != PROBE_CACHE_VERSION
+            || obj["path"].toString() != path)
+        return PEntry();
+    PEntry entry = std::make_shared<Entry>();
+    entry->path = path;
+    entry->size = obj["size"].toString().toLongLong();
+    entry->lastModified = obj["lastModified"].toString().toLongLong();
+    QJsonObject outputs = obj["outputs"].toObject();
+    for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
+        entry->outputs.insert(it.key(),
+                              QByteArray::fromBase64(it.value().toString().toLatin1()));
+    }
+    return entry;
+}
+
+void CompilerProbeCache::saveEntry(const PEntry &entry)
+{
+    QDir dir(mDir);
+    if (!dir.exists() && !dir.mkpath(mDir))
+        return;
+    QJsonObject outputs;
+    for (auto it = entry->outputs.constBegin(); it != entry->outputs.constEnd(); ++it) {
+        outputs[it.key()] = QString::fromLatin1(it.value().toBase64());
+    }
+    QJsonObject obj;
+    obj["version"] = PROBE_CACHE_VERSION;
+    obj["path"] = entry->path;
+    obj["size"] = QString::number(entry->size);
+    obj["lastModified"] = QString::number(entry->lastModified);
+    obj["outputs"] = outputs;
+    QString path = entryPath(entry->path);
+    QString tempPath = path + ".tmp";
+    QFile file(tempPath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return;
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    file.close();
+    QFile::remove(path);
+    QFile::rename(tempPath, path);
+}
+
+QString CompilerProbeCache::entryPath(const QString &path) const
+{
+    QByteArray hash = QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return includeTrailingPathDelimiter(mDir) + QString::fromLatin1(hash) + ".json";
+}
+
+QString CompilerProbeCache::probeKey(const QString &workingDir, const QStringList &arguments)
+{
+    QString key = workingDir + "\n" + arguments.join("\n");
+    //files read by the compiler (-include, -imacros, @file, -specs=...) change the output, too
+    QDir dir(workingDir);
+    foreach (const QString& argument, arguments) {
+        QStringList candidates{argument};
+        if (argument.startsWith('@'))
+            candidates.append(argument.mid(1));
+        int pos = argument.indexOf('=');
+        if (pos >= 0)
+            candidates.append(argument.mid(pos + 1));
+        foreach (const QString& option, QStringList({"-include", "-imacros"})) {
+            if (argument.startsWith(option) && argument.length() > option.length())
+                candidates.append(argument.mid(option.length()));
+        }
+        foreach (const QString& candidate, candidates) {
+            if (candidate.isEmpty())
+                continue;
+            QFileInfo info(dir.absoluteFilePath(candidate));
+            if (!info.isFile())
+                continue;
+            key += QString("\n%1|%2|%3").arg(info.absoluteFilePath())
+                    .arg(info.size())
+                    .arg(info.lastModified().toMSecsSinceEpoch());
+            break;
+        }
+    }
+    return key;
+}
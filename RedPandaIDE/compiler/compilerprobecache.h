@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COMPILERPROBECACHE_H
+#define COMPILERPROBECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+/*
+ * Disk cache of the outputs of compiler probes (-v, -dumpmachine, -dM -E, search dirs...).
+ * Entries are kept per compiler binary and dropped when the binary's path, size or mtime changes,
+ * so compiler sets can be loaded and parsers reset without running the compiler again.
+ * Files named in the arguments are part of the probe's key, and the cache is cleared
+ * when compilers are searched for again.
+ */
+class CompilerProbeCache
+{
+public:
+    explicit CompilerProbeCache(const QString& dir);
+    CompilerProbeCache(const CompilerProbeCache&)=delete;
+    CompilerProbeCache& operator=(const CompilerProbeCache&)=delete;
+
+    bool fetch(const QString& binFile, const QString& workingDir,
+               const QStringList& arguments, QByteArray& output);
+    void store(const QString& binFile, const QString& workingDir,
+               const QStringList& arguments, const QByteArray& output);
+    void clear();
+
+    static CompilerProbeCache* instance();
+private:
+    struct Entry {
+        QString path;
+        qint64 size;
+        qint64 lastModified;
+        QHash<QString,QByteArray> outputs;
+    };
+    using PEntry = std::shared_ptr<Entry>;
+
+    PEntry getEntry(const QString& binFile);
+    PEntry loadEntry(const QString& path);
+    void saveEntry(const PEntry& entry);
+    QString entryPath(const QString& path) const;
+    static QString probeKey(const QString& workingDir, const QStringList& arguments);
+private:
+    QString mDir;
+    QHash<QString,PEntry> mEntries;
+    QMutex mMutex;
+};
+
+#endif // COMPILERPROBECACHE_H
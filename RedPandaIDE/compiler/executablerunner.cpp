@@ -24,11 +24,27 @@
 #include <QUuid>
 #include <windows.h>
 #else
+#include <QDir>
+#include <QFile>
+#include <errno.h>
+#include <poll.h>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/stat.h>        /* For mode constants */
 #include <fcntl.h>           /* For O_* constants */
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+#endif
+
+#ifndef Q_OS_WIN
+static void drainFd(int fd)
+{
+    char buf[64];
+    while (read(fd, buf, sizeof(buf))>0)
+        ;
+}
 #endif
 
 
@@ -40,6 +56,30 @@ ExecutableRunner::ExecutableRunner(const QString &filename, const QStringList &a
     mQuitSemaphore(0)
 {
     setWaitForFinishTime(1000);
+#ifndef Q_OS_WIN
+    int fds[2];
+    if (pipe(fds)==0) {
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+        mWakeReadFd = fds[0];
+        mWakeWriteFd = fds[1];
+    } else {
+        mWakeReadFd = -1;
+        mWakeWriteFd = -1;
+    }
+#endif
+}
+
+ExecutableRunner::~ExecutableRunner()
+{
+#ifndef Q_OS_WIN
+    if (mWakeReadFd!=-1)
+        close(mWakeReadFd);
+    if (mWakeWriteFd!=-1)
+        close(mWakeWriteFd);
+#endif
 }
 
 bool ExecutableRunner::startConsole() const
@@ -123,6 +163,14 @@ void ExecutableRunner::run()
     }
     env.insert("PATH",path);
     mProcess->setProcessEnvironment(env);
+#ifndef Q_OS_WIN
+    //the input file is connected to stdin directly, and the output isn't read by anyone,
+    //so the runner thread doesn't have to wake up to pump the pipes
+    if (redirectInput())
+        mProcess->setStandardInputFile(redirectInputFilename());
+    mProcess->setStandardOutputFile(QProcess::nullDevice());
+    mProcess->setStandardErrorFile(QProcess::nullDevice());
+#endif
     connect(
                 mProcess.get(), &QProcess::errorOccurred,
                 [&errorOccurred](){
@@ -139,7 +187,7 @@ void ExecutableRunner::run()
         }
     });
     HANDLE hSharedMemory=INVALID_HANDLE_VALUE;
-    int BUF_SIZE=1024;
+    int BUF_SIZE=CONSOLE_PAUSER_SHM_SIZE;
     char* pBuf=nullptr;
     if (mStartConsole) {
         hSharedMemory = CreateFileMappingA(
@@ -163,7 +211,7 @@ void ExecutableRunner::run()
         }
     }
 #else
-    int BUF_SIZE=1024;
+    int BUF_SIZE=CONSOLE_PAUSER_SHM_SIZE;
     char* pBuf=nullptr;
     int fd_shm = shm_open(mShareMemoryId.toLocal8Bit().data(),O_RDWR | O_CREAT,S_IRWXU);
     if (fd_shm==-1) {
@@ -179,23 +227,65 @@ void ExecutableRunner::run()
             }
         }
     }
+    //consolepauser runs in a terminal emulator, so it can't inherit a descriptor from us.
+    //It finds this fifo by the path in the shared memory, and writes to it when the program finishes.
+    QByteArray notifyPath;
+    int notifyFd = -1;
+    int notifyWriteFd = -1;
+    if (mStartConsole && pBuf) {
+        notifyPath = QFile::encodeName(QDir::tempPath()+"/redpanda"+mShareMemoryId.mid(1)+".fifo");
+        if (notifyPath.length() < BUF_SIZE - CONSOLE_PAUSER_SHM_NOTIFY_PATH_OFFSET
+                && mkfifo(notifyPath.constData(), S_IRUSR | S_IWUSR)==0) {
+            notifyFd = open(notifyPath.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            //keep a writer open, or the fifo polls as hung up after consolepauser closes it
+            notifyWriteFd = open(notifyPath.constData(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (notifyFd!=-1 && notifyWriteFd!=-1)
+                strcpy(pBuf+CONSOLE_PAUSER_SHM_NOTIFY_PATH_OFFSET, notifyPath.constData());
+        } else {
+            qDebug()<<QString("mkfifo failed %1:%2").arg(errno).arg(strerror(errno));
+            notifyPath.clear();
+        }
+    }
+    auto closeNotifyFifo = [&notifyPath, &notifyFd, &notifyWriteFd]() {
+        if (notifyFd!=-1)
+            close(notifyFd);
+        if (notifyWriteFd!=-1)
+            close(notifyWriteFd);
+        if (!notifyPath.isEmpty())
+            unlink(notifyPath.constData());
+        notifyFd = -1;
+        notifyWriteFd = -1;
+        notifyPath.clear();
+    };
 #endif
-//    if (!redirectInput()) {
-//        process.closeWriteChannel();
-//    }
     mProcess->start();
     mProcess->waitForStarted(5000);
+#ifdef Q_OS_WIN
     if (mProcess->state()==QProcess::Running && redirectInput()) {
         mProcess->write(readFileToByteArray(redirectInputFilename()));
         mProcess->waitForFinished(0);
     }
     bool writeChannelClosed = false;
-    while (true) {
+#else
+    int pidFd = -1;
+#ifdef SYS_pidfd_open
+    if (mProcess->state()==QProcess::Running)
+        pidFd = syscall(SYS_pidfd_open, (pid_t)mProcess->processId(), 0);
+#endif
+#endif
+    while (mProcess->state()==QProcess::Running) {
+#ifdef Q_OS_WIN
         if (mProcess->bytesToWrite()==0 && redirectInput() && !writeChannelClosed) {
             writeChannelClosed=true;
             mProcess->closeWriteChannel();
         }
         mProcess->waitForFinished(mWaitForFinishTime);
+#else
+        //once the pidfd is readable, QProcess is about to get the exit status
+        bool exited = waitForEvent(pidFd, notifyFd);
+        if (mProcess->waitForFinished(exited?-1:0))
+            break;
+#endif
         if (mProcess->state()!=QProcess::Running) {
             break;
         }
@@ -216,6 +306,7 @@ void ExecutableRunner::run()
         }
         if (mStartConsole && !mPausing && pBuf) {
             if (strncmp(pBuf,"FINISHED",sizeof("FINISHED"))==0) {
+                reportRunStatistics(pBuf+CONSOLE_PAUSER_SHM_USAGE_OFFSET);
 #ifdef Q_OS_WIN
                 if (pBuf) {
                     UnmapViewOfFile(pBuf);
@@ -234,6 +325,7 @@ void ExecutableRunner::run()
                     shm_unlink(mShareMemoryId.toLocal8Bit().data());
                     fd_shm = -1;
                 }
+                closeNotifyFifo();
 #endif
                 setPausing(true);
                 emit pausingForFinish();
@@ -246,6 +338,13 @@ void ExecutableRunner::run()
     if (hSharedMemory!=INVALID_HANDLE_VALUE && hSharedMemory!=NULL)
         CloseHandle(hSharedMemory);
 #else
+    if (pidFd!=-1)
+        close(pidFd);
+    closeNotifyFifo();
+    //the program may exit before it's seen as finished, when the console isn't paused
+    if (mStartConsole && !mPausing && pBuf
+            && strncmp(pBuf,"FINISHED",sizeof("FINISHED"))==0)
+        reportRunStatistics(pBuf+CONSOLE_PAUSER_SHM_USAGE_OFFSET);
     if (pBuf) {
         munmap(pBuf,BUF_SIZE);
     }
@@ -279,7 +378,78 @@ void ExecutableRunner::run()
     mQuitSemaphore.release(1);
 }
 
+void ExecutableRunner::reportRunStatistics(const char *usage)
+{
+    //consolepauser on Windows doesn't write statistics
+    ProgramRunStatistics statistics;
+    long long elapsedTime, userTime, systemTime, peakMemory;
+    long long minorPageFaults, majorPageFaults, voluntaryContextSwitches, involuntaryContextSwitches;
+    if (sscanf(usage, "%d %lld %lld %lld %lld %lld %lld %lld %lld",
+               &statistics.exitCode,
+               &elapsedTime, &userTime, &systemTime, &peakMemory,
+               &minorPageFaults, &majorPageFaults,
+               &voluntaryContextSwitches, &involuntaryContextSwitches)!=9)
+        return;
+    statistics.elapsedTime = elapsedTime;
+    statistics.userTime = userTime;
+    statistics.systemTime = systemTime;
+    statistics.peakMemory = peakMemory;
+    statistics.minorPageFaults = minorPageFaults;
+    statistics.majorPageFaults = majorPageFaults;
+    statistics.voluntaryContextSwitches = voluntaryContextSwitches;
+    statistics.involuntaryContextSwitches = involuntaryContextSwitches;
+    emit runStatisticsReady(statistics);
+}
+
+#ifndef Q_OS_WIN
+bool ExecutableRunner::waitForEvent(int pidFd, int notifyFd)
+{
+    struct pollfd fds[3];
+    int count = 0;
+    if (mWakeReadFd!=-1) {
+        fds[count].fd = mWakeReadFd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+    int pidIndex = -1;
+    if (pidFd!=-1) {
+        pidIndex = count;
+        fds[count].fd = pidFd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+    if (notifyFd!=-1) {
+        fds[count].fd = notifyFd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+    //without a pidfd (or a fifo to hear from consolepauser), fall back to checking regularly
+    int timeout = -1;
+    if (pidFd==-1 || (mStartConsole && !mPausing && notifyFd==-1))
+        timeout = mWaitForFinishTime;
+    for (int i=0;i<count;i++)
+        fds[i].revents = 0;
+    if (!mStop) {
+        int ret = poll(fds, count, timeout);
+        if (ret==-1 && errno!=EINTR)
+            qDebug()<<QString("poll failed %1:%2").arg(errno).arg(strerror(errno));
+    }
+    if (mWakeReadFd!=-1)
+        drainFd(mWakeReadFd);
+    if (notifyFd!=-1)
+        drainFd(notifyFd);
+    return pidIndex!=-1 && (fds[pidIndex].revents & POLLIN);
+}
+#endif
+
 void ExecutableRunner::doStop()
 {
+#ifndef Q_OS_WIN
+    if (mWakeWriteFd!=-1) {
+        char c = 0;
+        if (write(mWakeWriteFd, &c, 1)==-1 && errno!=EAGAIN)
+            qDebug()<<QString("wake runner failed %1:%2").arg(errno).arg(strerror(errno));
+    }
+#endif
     mQuitSemaphore.acquire(1);
 }
@@ -22,6 +22,20 @@
 #include <QSemaphore>
 #include <memory>
 
+// resource usage of a program run by consolepauser
+struct ProgramRunStatistics {
+    int exitCode;
+    qint64 elapsedTime; // us
+    qint64 userTime; // us
+    qint64 systemTime; // us
+    qint64 peakMemory; // kb
+    qint64 minorPageFaults;
+    qint64 majorPageFaults;
+    qint64 voluntaryContextSwitches;
+    qint64 involuntaryContextSwitches;
+};
+Q_DECLARE_METATYPE(ProgramRunStatistics);
+
 class ExecutableRunner : public Runner
 {
     Q_OBJECT
@@ -30,6 +44,7 @@ public:
                      QObject* parent = nullptr);
     ExecutableRunner(const ExecutableRunner&)=delete;
     ExecutableRunner& operator=(const ExecutableRunner&)=delete;
+    ~ExecutableRunner();
 
     const QString &redirectInputFilename() const;
     void setRedirectInputFilename(const QString &newDataFile);
@@ -48,6 +63,16 @@ public:
     void addBinDirs(const QStringList &binDirs);
     void addBinDir(const QString &binDir);
 
+signals:
+    void runStatisticsReady(const ProgramRunStatistics& statistics);
+
+private:
+#ifndef Q_OS_WIN
+    // wait until the process exits, consolepauser notifies, or the runner is stopped.
+    // returns true if the process has exited
+    bool waitForEvent(int pidFd, int notifyFd);
+#endif
+    void reportRunStatistics(const char* usage);
 private:
     QString mRedirectInputFilename;
     QString mShareMemoryId;
@@ -56,6 +81,11 @@ private:
     std::shared_ptr<QProcess> mProcess;
     QSemaphore mQuitSemaphore;
     QStringList mBinDirs;
+#ifndef Q_OS_WIN
+    // self-pipe written by doStop() to wake up the runner thread
+    int mWakeReadFd;
+    int mWakeWriteFd;
+#endif
 
     // QThread interface
 protected:
@@ -111,6 +111,7 @@ bool FileCompiler::prepareForCompile()
         }
     }
 
+    int flagsStart = mArguments.count();
     mArguments += getCharsetArgument(mEncoding, fileType, mOnlyCheckSyntax);
     QString strFileType;
     switch(fileType) {
@@ -140,6 +141,7 @@ bool FileCompiler::prepareForCompile()
     default:
         throw CompileError(tr("Can't find the compiler for file %1").arg(mFilename));
     }
+    QStringList compileFlags = mArguments.mid(flagsStart);
     if (!mOnlyCheckSyntax)
         mArguments += getLibraryArguments(fileType);
 
@@ -183,6 +185,31 @@ bool FileCompiler::prepareForCompile()
                     +tr("Please check the \"program\" page of compiler settings."));
     }
 
+    //preprocessed and assembly output should not contain the precompiled header
+    if (fileType != FileType::GAS
+            && (mOnlyCheckSyntax
+                || compilerSet()->compilationStage() == Settings::CompilerSet::CompilationStage::AssemblingOnly
+                || compilerSet()->compilationStage() == Settings::CompilerSet::CompilationStage::GenerateExecutable)) {
+        QStringList pchArguments = getPrecompiledHeaderArguments(
+                    fileType == FileType::CppSource,
+                    compileFlags,
+                    QString::fromUtf8(readFileToByteArray(mFilename)));
+        mArguments += pchArguments;
+        compileFlags += pchArguments;
+    }
+
+    if (fileType != FileType::GAS) {
+        QStringList diagnosticsArguments = getStructuredDiagnosticsArguments();
+        mArguments += diagnosticsArguments;
+        mStructuredDiagnostics = !diagnosticsArguments.isEmpty();
+    }
+
+    if (fileType != FileType::GAS && !mOnlyCheckSyntax
+            && compilerSet()->compilationStage() == Settings::CompilerSet::CompilationStage::GenerateExecutable) {
+        mObjectCache = createObjectCache();
+        mPreprocessFlags = compileFlags;
+    }
+
     log(tr("Processing %1 source file:").arg(strFileType));
     log("------------------");
     log(tr("%1 Compiler: %2").arg(strFileType).arg(mCompiler));
@@ -192,6 +219,40 @@ bool FileCompiler::prepareForCompile()
     return true;
 }
 
+bool FileCompiler::fetchOutputFromCache()
+{
+    if (!mObjectCache)
+        return false;
+    QStringList keyArguments = mArguments;
+    int pos = keyArguments.indexOf("-o");
+    if (pos >= 0)
+        keyArguments.erase(keyArguments.begin() + pos, keyArguments.begin() + std::min(pos + 2, keyArguments.count()));
+    //the executable is linked, it's stale once a library or object file it's linked with changes
+    keyArguments += getLinkInputsFingerprint(mArguments, mDirectory);
+    mObjectCacheKey = computeObjectCacheKey(mCompiler, mFilename, mPreprocessFlags, keyArguments, mDirectory);
+    if (mObjectCacheKey.isEmpty())
+        return false;
+    QString diagnostics;
+    if (!mObjectCache->fetch(mObjectCacheKey, mOutputFile, diagnostics))
+        return false;
+    log(tr("- Reused '%1' from the object cache.").arg(mOutputFile));
+    //replay the warnings of the cached build
+    if (!diagnostics.isEmpty()) {
+        error(diagnostics);
+        error(COMPILE_PROCESS_END);
+    }
+    mObjectCacheKey.clear();
+    return true;
+}
+
+void FileCompiler::storeOutputToCache()
+{
+    if (!mObjectCache || mObjectCacheKey.isEmpty() || mErrorCount > 0)
+        return;
+    mObjectCache->store(mObjectCacheKey, mOutputFile, mCompilerDiagnostics);
+    mObjectCache->prune();
+}
+
 bool FileCompiler::prepareForRebuild()
 {
     QString exeName=compilerSet()->getOutputFilename(mFilename);
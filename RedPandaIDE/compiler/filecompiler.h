@@ -35,9 +35,13 @@ protected:
 private:
     QByteArray mEncoding;
     CppCompileType mCompileType;
+    QStringList mPreprocessFlags;
+    QByteArray mObjectCacheKey;
     // Compiler interface
 protected:
     bool prepareForRebuild() override;
+    bool fetchOutputFromCache() override;
+    void storeOutputToCache() override;
 };
 
 #endif // FILECOMPILER_H
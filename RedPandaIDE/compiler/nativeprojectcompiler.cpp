@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "nativeprojectcompiler.h"
+#include "../project.h"
+#include "../systemconsts.h"
+#include "compilerinfo.h"
+#include "qt_utils/utils.h"
+#include "utils.h"
+#include "utils/parsearg.h"
+
+#include <QDir>
+#include <QProcess>
+#include <QThreadPool>
+
+#define PROCESS_START_TIMEOUT 5000
+#define PROCESS_POLL_INTERVAL 100
+
+NativeProjectCompiler::NativeProjectCompiler(std::shared_ptr<Project> project):
+    ProjectCompiler{project},
+    mOutputUTF8{false},
+    mJobs{1},
+    mStartedSteps{0},
+    mTotalSteps{0}
+{
+}
+
+bool NativeProjectCompiler::supportsProject(const std::shared_ptr<Project> &project)
+{
+    const ProjectOptions& options = project->options();
+    if (options.useCustomMakefile && !options.customMakefile.isEmpty())
+        return false;
+    //makefile includes and custom build commands are written in make syntax
+    if (!options.makeIncludes.isEmpty())
+        return false;
+    if (options.type == ProjectType::DynamicLib)
+        return false;
+    foreach (const PProjectUnit& unit, project->unitList()) {
+        if (unit->compile() && unit->overrideBuildCmd() && !unit->buildCmd().isEmpty())
+            return false;
+    }
+    return true;
+}
+
+NativeProjectCompiler::PBuildStep NativeProjectCompiler::createCompileStep(
+        const PProjectUnit &unit, const QStringList &cFlags, const QStringList &cxxFlags)
+{
+    FileType fileType = getFileType(unit->fileName());
+    PBuildStep step = std::make_shared<BuildStep>();
+    QString sourceFile = extractRelativePath(mDirectory, unit->fileName());
+    step->outputFile = getUnitObjectFile(unit);
+    QString objectFile = extractRelativePath(mDirectory, step->outputFile);
+    step->description = tr("Compiling %1").arg(sourceFile);
+    step->inputFiles.append(unit->fileName());
+    step->arguments = QStringList{"-c", sourceFile, "-o", objectFile};
+    if (fileType == FileType::GAS) {
+        step->program = compilerSet()->CCompiler();
+        step->arguments += cFlags;
+    } else {
+        if (unit->compileCpp()) {
+            step->program = compilerSet()->cppCompiler();
+            step->arguments += cxxFlags;
+            if (mPrecompiledHeaderStep)
+                step->inputFiles.append(mPrecompiledHeaderStep->outputFile);
+        } else {
+            step->program = compilerSet()->CCompiler();
+            step->arguments += cFlags;
+        }
+        //-MMD writes the dependency file next to the object file
+        step->arguments << "-MMD" << "-MP";
+        step->arguments += mDiagnosticsArguments;
+        step->dependencyFile = changeFileExt(step->outputFile, DEP_EXT);
+    }
+    step->arguments += getUnitCharsetArguments(unit);
+    return step;
+}
+
+NativeProjectCompiler::PBuildStep NativeProjectCompiler::createPrecompiledHeaderStep(const QStringList &cxxFlags)
+{
+    const ProjectOptions& options = mProject->options();
+    if (!options.usePrecompiledHeader || !fileExists(options.precompiledHeader))
+        return PBuildStep();
+    PBuildStep step = std::make_shared<BuildStep>();
+    QString header = extractRelativePath(mDirectory, options.precompiledHeader);
+    step->outputFile = options.precompiledHeader + "." GCH_EXT;
+    step->dependencyFile = changeFileExt(step->outputFile, DEP_EXT);
+    step->description = tr("Precompiling %1").arg(header);
+    step->inputFiles.append(options.precompiledHeader);
+    step->program = compilerSet()->cppCompiler();
+    step->arguments = QStringList{"-c", header, "-o", extractRelativePath(mDirectory, step->outputFile)}
+            + cxxFlags
+            + QStringList{"-MMD", "-MP", "-MF", extractRelativePath(mDirectory, step->dependencyFile)}
+            + mDiagnosticsArguments;
+    return step;
+}
+
+NativeProjectCompiler::PBuildStep NativeProjectCompiler::createResourceStep()
+{
+#ifdef Q_OS_WIN
+    const ProjectOptions& options = mProject->options();
+    if (options.privateResource.isEmpty())
+        return PBuildStep();
+    PBuildStep step = std::make_shared<BuildStep>();
+    QString resFile = changeFileExt(options.privateResource, RES_EXT);
+    if (!options.folderForObjFiles.isEmpty())
+        resFile = includeTrailingPathDelimiter(options.folderForObjFiles) + resFile;
+    step->outputFile = generateAbsolutePath(mDirectory, resFile);
+    QString privateResource = generateAbsolutePath(mDirectory, options.privateResource);
+    step->description = tr("Compiling %1").arg(extractRelativePath(mDirectory, privateResource));
+    step->inputFiles.append(privateResource);
+    foreach (const PProjectUnit& unit, mProject->unitList()) {
+        if (getFileType(unit->fileName()) == FileType::WindowsResourceSource)
+            step->inputFiles.append(unit->fileName());
+    }
+    step->program = compilerSet()->resourceCompiler();
+    step->arguments = QStringList{"-i", extractRelativePath(mDirectory, privateResource)};
+    if (mProject->getCompileOption(CC_CMD_OPT_POINTER_SIZE)=="32")
+        step->arguments << "-F" << "pe-i386";
+    step->arguments << "--input-format=rc"
+                    << "-o" << extractRelativePath(mDirectory, step->outputFile)
+                    << "-O" << "coff";
+    step->arguments += parseArguments(options.resourceCmd, devCppMacroVariables(), true);
+    foreach (const QString& dir, options.resourceIncludes) {
+        if (!dir.isEmpty())
+            step->arguments << "--include-dir" << dir;
+    }
+    return step;
+#else
+    return PBuildStep();
+#endif
+}
+
+NativeProjectCompiler::PBuildStep NativeProjectCompiler::createLinkStep(const QStringList &objects, const QStringList &linkObjects)
+{
+    PBuildStep step = std::make_shared<BuildStep>();
+    step->outputFile = mProject->outputFilename();
+    QString outputFile = extractRelativePath(mDirectory, step->outputFile);
+    step->inputFiles = objects;
+    if (mProject->options().type == ProjectType::StaticLib) {
+        step->description = tr("Archiving %1").arg(outputFile);
+        step->program = findProgram(AR_PROGRAM);
+        step->arguments = QStringList{"rcs", outputFile} + linkObjects;
+    } else {
+        step->description = tr("Linking %1").arg(outputFile);
+        if (mProject->options().isCpp)
+            step->program = compilerSet()->cppCompiler();
+        else
+            step->program = compilerSet()->CCompiler();
+        step->arguments = linkObjects + QStringList{"-o", outputFile}
+                + getLibraryArguments(FileType::Project);
+    }
+    return step;
+}
+
+bool NativeProjectCompiler::isUpToDate(const PBuildStep &step)
+{
+    QDateTime outputTime = lastModified(step->outputFile);
+    if (!outputTime.isValid())
+        return false;
+    QStringList inputs = step->inputFiles;
+    if (!step->dependencyFile.isEmpty()) {
+        QStringList prerequisites = parseDependencyFile(step->dependencyFile);
+        //without the dependency file we don't know which headers are used
+        if (prerequisites.isEmpty())
+            return false;
+        inputs += prerequisites;
+    }
+    foreach (const QString& input, inputs) {
+        QDateTime inputTime = lastModified(generateAbsolutePath(mDirectory, input));
+        if (!inputTime.isValid() || inputTime > outputTime)
+            return false;
+    }
+    return true;
+}
+
+QDateTime NativeProjectCompiler::lastModified(const QString &filename)
+{
+    //headers are shared by many units, stat them only once
+    auto it = mTimestamps.constFind(filename);
+    if (it != mTimestamps.constEnd())
+        return it.value();
+    QFileInfo info(filename);
+    QDateTime time = info.exists() ? info.lastModified() : QDateTime();
+    mTimestamps.insert(filename, time);
+    return time;
+}
+
+bool NativeProjectCompiler::runSteps(const QList<PBuildStep> &steps)
+{
+    QList<PBuildStep> staleSteps;
+    foreach (const PBuildStep& step, steps) {
+        if (!isUpToDate(step))
+            staleSteps.append(step);
+    }
+    if (staleSteps.isEmpty())
+        return true;
+    mTotalSteps += staleSteps.count();
+    std::atomic_bool failed{false};
+    QThreadPool pool;
+    pool.setMaxThreadCount(mJobs);
+    foreach (const PBuildStep& step, staleSteps) {
+        pool.start(QRunnable::create([this, step, &failed](){
+            //like make, don't start new steps after a failure
+            if (failed || mStop)
+                return;
+            if (!runStep(step))
+                failed = true;
+        }));
+    }
+    pool.waitForDone();
+    foreach (const PBuildStep& step, staleSteps)
+        mTimestamps.remove(step->outputFile);
+    return !failed && !mStop;
+}
+
+bool NativeProjectCompiler::runStep(const PBuildStep &step)
+{
+    {
+        QMutexLocker locker(&mOutputMutex);
+        mStartedSteps++;
+        log(QString("[%1/%2] %3").arg(mStartedSteps).arg(mTotalSteps).arg(step->description));
+    }
+    QProcess process;
+    process.setProgram(step->program);
+    process.setArguments(step->arguments);
+    process.setWorkingDirectory(mDirectory);
+    process.setProcessEnvironment(mEnvironment);
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start();
+    if (!process.waitForStarted(PROCESS_START_TIMEOUT)) {
+        QMutexLocker locker(&mOutputMutex);
+        log(tr("Failed to start '%1'.").arg(step->program));
+        return false;
+    }
+    while (!process.waitForFinished(PROCESS_POLL_INTERVAL)) {
+        if (process.state() == QProcess::NotRunning)
+            break;
+        if (mStop) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+    }
+    QByteArray output = process.readAll();
+    bool succeeded = process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+
+    QMutexLocker locker(&mOutputMutex);
+    //report the diagnostics of a step together, so they don't interleave with other steps
+    if (!output.isEmpty())
+        error(mOutputUTF8 ? QString::fromUtf8(output) : QString::fromLocal8Bit(output));
+    error(COMPILE_PROCESS_END);
+    if (!succeeded)
+        log(tr("Failed: %1").arg(escapeCommandForLog(step->program, step->arguments)));
+    return succeeded;
+}
+
+void NativeProjectCompiler::removeOutputs()
+{
+    QList<PBuildStep> steps = mCompileSteps;
+    if (mPrecompiledHeaderStep)
+        steps.append(mPrecompiledHeaderStep);
+    if (mLinkStep)
+        steps.append(mLinkStep);
+    int count = 0;
+    foreach (const PBuildStep& step, steps) {
+        QStringList outputs{step->outputFile, step->dependencyFile};
+        if (!step->dependencyFile.isEmpty())
+            outputs.append(changeFileExt(step->outputFile, DWO_EXT));
+        foreach (const QString& filename, outputs) {
+            if (!filename.isEmpty() && fileExists(filename) && QFile::remove(filename))
+                count++;
+        }
+    }
+    log(tr("- %1 file(s) removed.").arg(count));
+}
+
+QString NativeProjectCompiler::findProgram(const QString &program)
+{
+    foreach (const QString& dir, compilerSet()->binDirs()) {
+        QString filename = includeTrailingPathDelimiter(dir) + program;
+        if (fileExists(filename))
+            return filename;
+    }
+    return program;
+}
+
+QStringList NativeProjectCompiler::parseDependencyFile(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly))
+        return QStringList();
+    QByteArray content = file.readAll();
+    QStringList result;
+    QByteArray current;
+    bool inPrerequisites = false;
+    auto flush = [&result, &current](){
+        if (!current.isEmpty())
+            result.append(QString::fromLocal8Bit(current));
+        current.clear();
+    };
+    //only the first rule is needed, the rest are the phony targets added by -MP
+    for (int i=0;i<content.length();i++) {
+        char ch = content[i];
+        char next = (i+1<content.length()) ? content[i+1] : '\0';
+        if (ch == '\\' && (next == '\n' || next == '\r')) {
+            flush();
+            i++;
+            if (next == '\r' && i+1<content.length() && content[i+1] == '\n')
+                i++;
+            continue;
+        }
+        if (ch == '\\' && (next == ' ' || next == '#')) {
+            current += next;
+            i++;
+            continue;
+        }
+        if (ch == '$' && next == '$') {
+            current += '$';
+            i++;
+            continue;
+        }
+        if (!inPrerequisites) {
+            //the colon of a windows drive letter is not followed by a space
+            if (ch == ':' && (next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == '\0')) {
+                inPrerequisites = true;
+                current.clear();
+            }
+            continue;
+        }
+        if (ch == ' ' || ch == '\t') {
+            flush();
+        } else if (ch == '\n' || ch == '\r') {
+            break;
+        } else {
+            current += ch;
+        }
+    }
+    flush();
+    return result;
+}
+
+bool NativeProjectCompiler::prepareForCompile()
+{
+    if (!mProject)
+        return false;
+    log(tr("Compiling project changes..."));
+    log("--------");
+    log(tr("- Project Filename: %1").arg(mProject->filename()));
+    log(tr("- Compiler Set Name: %1").arg(compilerSet()->name()));
+    log("");
+
+    const ProjectOptions& options = mProject->options();
+    mDirectory = mProject->directory();
+    if (!options.folderForObjFiles.isEmpty())
+        QDir(mDirectory).mkpath(options.folderForObjFiles);
+    if (!options.folderForOutput.isEmpty())
+        QDir(mDirectory).mkpath(options.folderForOutput);
+    mEnvironment = getProcessEnvironment(compilerSet()->CCompiler());
+    mOutputUTF8 = compilerSet()->isCompilerInfoUsingUTF8();
+    if (options.allowParallelBuilding) {
+        mJobs = options.parellelBuildingJobs > 0 ? options.parellelBuildingJobs : QThread::idealThreadCount();
+    } else {
+        mJobs = 1;
+    }
+
+    //diagnostics of each step are captured separately, so they can be structured
+    mDiagnosticsArguments = getStructuredDiagnosticsArguments();
+    mStructuredDiagnostics = !mDiagnosticsArguments.isEmpty();
+
+    QStringList cFlags = getCIncludeArguments() + getProjectIncludeArguments()
+            + getReflextiveArguments() + getCCompileArguments(false);
+    QStringList cxxFlags = getCppIncludeArguments() + getProjectIncludeArguments()
+            + getReflextiveArguments() + getCppCompileArguments(false);
+
+    mPrecompiledHeaderStep = createPrecompiledHeaderStep(cxxFlags);
+    mCompileSteps.clear();
+    QStringList objects;
+    QStringList linkObjects;
+    foreach (const PProjectUnit& unit, mProject->unitList()) {
+        if (!unit->compile())
+            continue;
+        FileType fileType = getFileType(unit->fileName());
+        if (fileType!=FileType::CSource && fileType!=FileType::CppSource
+                && fileType!=FileType::GAS)
+            continue;
+        PBuildStep step = createCompileStep(unit, cFlags, cxxFlags);
+        mCompileSteps.append(step);
+        objects.append(step->outputFile);
+        if (unit->link())
+            linkObjects.append(extractRelativePath(mDirectory, step->outputFile));
+    }
+    PBuildStep resourceStep = createResourceStep();
+    if (resourceStep) {
+        mCompileSteps.append(resourceStep);
+        objects.append(resourceStep->outputFile);
+        linkObjects.append(extractRelativePath(mDirectory, resourceStep->outputFile));
+    }
+    mLinkStep = createLinkStep(objects, linkObjects);
+    mOutputFile = mProject->outputFilename();
+
+    //split debug info (.dwo) is not cached
+    if (!onlyClean() && !useSplitDebugInfo())
+        mObjectCache = createObjectCache();
+
+    log(tr("Building without makefile:"));
+    log("--------");
+    log(tr("- Units: %1").arg(mCompileSteps.count()));
+    log(tr("- Parallel Jobs: %1").arg(mJobs));
+    QString linker = findFastLinker();
+    if (!linker.isEmpty() && mProject->options().type != ProjectType::StaticLib)
+        log(tr("- Linker: %1").arg(linker));
+    log("");
+    return true;
+}
+
+bool NativeProjectCompiler::prepareForRebuild()
+{
+    removeOutputs();
+    return true;
+}
+
+bool NativeProjectCompiler::fetchOutputFromCache()
+{
+    //outputs of a rebuild are already removed in prepareForRebuild()
+    restoreObjectsFromCache();
+    return false;
+}
+
+void NativeProjectCompiler::runMainCommand()
+{
+    if (onlyClean()) {
+        removeOutputs();
+        return;
+    }
+    mTimestamps.clear();
+    mStartedSteps = 0;
+    mTotalSteps = 0;
+    if (mPrecompiledHeaderStep && !runSteps({mPrecompiledHeaderStep}))
+        return;
+    if (!runSteps(mCompileSteps))
+        return;
+    //ar appends to an existing archive, start from scratch
+    if (mProject->options().type == ProjectType::StaticLib && !isUpToDate(mLinkStep)) {
+        QFile::remove(mLinkStep->outputFile);
+        mTimestamps.remove(mLinkStep->outputFile);
+    }
+    startLinkPhase();
+    if (runSteps({mLinkStep}) && mStartedSteps == 0)
+        log(tr("Nothing to be done."));
+}
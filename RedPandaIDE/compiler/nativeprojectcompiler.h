@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef NATIVEPROJECTCOMPILER_H
+#define NATIVEPROJECTCOMPILER_H
+
+#include "projectcompiler.h"
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+
+/*
+ * Builds a project without make.
+ * Stale units are found from file timestamps and the dependency files written by the compiler,
+ * and compiled in parallel. The target is linked when any of its objects changed.
+ */
+class NativeProjectCompiler : public ProjectCompiler
+{
+    Q_OBJECT
+public:
+    NativeProjectCompiler(std::shared_ptr<Project> project);
+    NativeProjectCompiler(const NativeProjectCompiler&)=delete;
+    NativeProjectCompiler& operator=(const NativeProjectCompiler&)=delete;
+
+    static bool supportsProject(const std::shared_ptr<Project>& project);
+
+private:
+    struct BuildStep {
+        QString description;
+        QString program;
+        QStringList arguments;
+        QString outputFile;
+        QString dependencyFile;
+        QStringList inputFiles;
+    };
+    using PBuildStep = std::shared_ptr<BuildStep>;
+
+    PBuildStep createCompileStep(const std::shared_ptr<ProjectUnit>& unit,
+                                 const QStringList& cFlags, const QStringList& cxxFlags);
+    PBuildStep createPrecompiledHeaderStep(const QStringList& cxxFlags);
+    PBuildStep createResourceStep();
+    PBuildStep createLinkStep(const QStringList& objects, const QStringList& linkObjects);
+    bool isUpToDate(const PBuildStep& step);
+    QDateTime lastModified(const QString& filename);
+    bool runSteps(const QList<PBuildStep>& steps);
+    bool runStep(const PBuildStep& step);
+    void removeOutputs();
+    QString findProgram(const QString& program);
+    static QStringList parseDependencyFile(const QString& filename);
+
+private:
+    PBuildStep mPrecompiledHeaderStep;
+    QList<PBuildStep> mCompileSteps;
+    PBuildStep mLinkStep;
+    QProcessEnvironment mEnvironment;
+    QStringList mDiagnosticsArguments;
+    QHash<QString,QDateTime> mTimestamps;
+    bool mOutputUTF8;
+    int mJobs;
+    int mStartedSteps;
+    int mTotalSteps;
+    QMutex mOutputMutex;
+
+    // Compiler interface
+protected:
+    bool prepareForCompile() override;
+    bool prepareForRebuild() override;
+    bool fetchOutputFromCache() override;
+    void runMainCommand() override;
+};
+
+#endif // NATIVEPROJECTCOMPILER_H
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "objectcache.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <algorithm>
+#include "qt_utils/utils.h"
+
+//the directory is rescanned after this many stores, in case other instances of the IDE share it
+#define OBJECT_CACHE_RESCAN_INTERVAL 256
+
+//all compilers share the cache directory, and so its bookkeeping
+static QMutex cacheMutex;
+//-1 : the directory is not scanned yet
+static qint64 cacheSize = -1;
+static int storesSinceScan = 0;
+
+ObjectCache::ObjectCache(const QString &dir, qint64 maxSize):
+    mDir{dir},
+    mMaxSize{maxSize},
+    mHits{0},
+    mMisses{0}
+{
+}
+
+bool ObjectCache::fetch(const QByteArray &key, const QString &outputFile, QString& diagnostics)
+{
+    QMutexLocker locker(&cacheMutex);
+    QString path = entryPath(key);
+    if (!fileExists(path)) {
+        mMisses++;
+        return false;
+    }
+    QFile::remove(outputFile);
+    if (!QFile::copy(path, outputFile)) {
+        mMisses++;
+        return false;
+    }
+    //mark the entry as recently used
+    QFile entry(path);
+    if (entry.open(QFile::ReadWrite))
+        entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    //the copy must be newer than its sources, or make will rebuild it
+    QFile output(outputFile);
+    if (output.open(QFile::ReadWrite))
+        output.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    diagnostics.clear();
+    QString logPath = path + ".log";
+    if (fileExists(logPath)) {
+        diagnostics = QString::fromUtf8(readFileToByteArray(logPath));
+        QFile log(logPath);
+        if (log.open(QFile::ReadWrite))
+            log.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+    mHits++;
+    return true;
+}
+
+void ObjectCache::store(const QByteArray &key, const QString &outputFile, const QString& diagnostics)
+{
+    if (!fileExists(outputFile))
+        return;
+    QMutexLocker locker(&cacheMutex);
+    QString path = entryPath(key);
+    QDir().mkpath(extractFileDir(path));
+    //copy to a temp name first, so a half written entry is never fetched
+    QString tempPath = path + ".tmp";
+    QFile::remove(tempPath);
+    if (!QFile::copy(outputFile, tempPath))
+        return;
+    QString logPath = path + ".log";
+    qint64 sizeChange = QFileInfo(tempPath).size()
+            - QFileInfo(path).size() - QFileInfo(logPath).size();
+    QFile::remove(logPath);
+    if (!diagnostics.isEmpty()) {
+        QFile log(logPath);
+        if (log.open(QFile::WriteOnly | QFile::Truncate)) {
+            qint64 written = log.write(diagnostics.toUtf8());
+            if (written > 0)
+                sizeChange += written;
+        }
+    }
+    QFile::remove(path);
+    QFile::rename(tempPath, path);
+    if (cacheSize >= 0)
+        cacheSize += sizeChange;
+    storesSinceScan++;
+}
+
+void ObjectCache::prune()
+{
+    QMutexLocker locker(&cacheMutex);
+    if (cacheSize < 0 || storesSinceScan >= OBJECT_CACHE_RESCAN_INTERVAL)
+        scan();
+    if (cacheSize <= mMaxSize)
+        return;
+    struct Entry {
+        QStringList files;
+        qint64 size;
+        QDateTime lastUsed;
+    };
+    //an entry, its log and its unfinished copy are evicted together
+    QHash<QString, Entry> entries;
+    QDirIterator it(mDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        QString path = info.absoluteFilePath();
+        QString entryPath = path;
+        if (path.endsWith(".log") || path.endsWith(".tmp"))
+            entryPath.chop(4);
+        Entry& entry = entries[entryPath];
+        if (entry.files.isEmpty()) {
+            entry.size = 0;
+            entry.lastUsed = info.lastModified();
+        }
+        entry.files.append(path);
+        entry.size += info.size();
+        entry.lastUsed = std::max(entry.lastUsed, info.lastModified());
+    }
+    QList<Entry> sortedEntries = entries.values();
+    std::sort(sortedEntries.begin(), sortedEntries.end(),
+              [](const Entry& a, const Entry& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    qint64 totalSize = 0;
+    foreach (const Entry& entry, sortedEntries)
+        totalSize += entry.size;
+    //leave some room, so the next few stores don't walk the directory again
+    qint64 targetSize = mMaxSize / 10 * 9;
+    foreach (const Entry& entry, sortedEntries) {
+        if (totalSize <= targetSize)
+            break;
+        foreach (const QString& file, entry.files) {
+            qint64 size = QFileInfo(file).size();
+            if (QFile::remove(file))
+                totalSize -= size;
+        }
+    }
+    cacheSize = totalSize;
+}
+
+void ObjectCache::scan()
+{
+    qint64 totalSize = 0;
+    QDirIterator it(mDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        totalSize += it.fileInfo().size();
+    }
+    cacheSize = totalSize;
+    storesSinceScan = 0;
+}
+
+int ObjectCache::hits() const
+{
+    return mHits;
+}
+
+int ObjectCache::misses() const
+{
+    return mMisses;
+}
+
+void ObjectCache::resetStatistics()
+{
+    mHits = 0;
+    mMisses = 0;
+}
+
+QString ObjectCache::entryPath(const QByteArray &key) const
+{
+    QString hex = QString::fromLatin1(key.toHex());
+    return includeTrailingPathDelimiter(mDir) + hex.left(2) + QDir::separator() + hex.mid(2);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef OBJECTCACHE_H
+#define OBJECTCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+/*
+ * Content addressed cache of compiler outputs (object files and executables).
+ * Keys are hashes of the compiler identity, the arguments and the preprocessed source.
+ * Entries are evicted in least recently used order when the cache grows over its size limit.
+ * The size of the cache is tracked across stores, the directory is only walked to evict entries.
+ */
+class ObjectCache
+{
+public:
+    explicit ObjectCache(const QString& dir, qint64 maxSize);
+    ObjectCache(const ObjectCache&)=delete;
+    ObjectCache& operator=(const ObjectCache&)=delete;
+
+    bool fetch(const QByteArray& key, const QString& outputFile, QString& diagnostics);
+    void store(const QByteArray& key, const QString& outputFile, const QString& diagnostics=QString());
+    void prune();
+
+    int hits() const;
+    int misses() const;
+    void resetStatistics();
+private:
+    QString entryPath(const QByteArray& key) const;
+    void scan();
+private:
+    QString mDir;
+    qint64 mMaxSize;
+    std::atomic_int mHits;
+    std::atomic_int mMisses;
+};
+
+using PObjectCache = std::shared_ptr<ObjectCache>;
+
+#endif // OBJECTCACHE_H
@@ -18,18 +18,108 @@
 #include "../utils.h"
 #include "../settings.h"
 #include "../systemconsts.h"
+#include <QDir>
 #include <QElapsedTimer>
 #include <QProcess>
+#include <QTemporaryFile>
+#include <QThreadPool>
 #ifdef Q_OS_WINDOWS
 #include <psapi.h>
 #endif
+//bytes of output kept in memory from the start, and from the end
+#define CASE_OUTPUT_PREVIEW_SIZE (64*1024)
 
+#ifdef Q_OS_LINUX
+#include "caseprocess.h"
+#include <signal.h>
+#include <string.h>
+//address space allowed beyond the memory limit, for shared libraries and thread stacks
+#define CASE_ADDRESS_SPACE_SLACK (64*1024*1024)
+//a program is killed when its wall time exceeds twice the time limit plus this (in milliseconds)
+#define CASE_WALL_TIME_SLACK 1000
+//a crash under the address space cap is taken as MLE if the peak memory reached this percent of the limit
+#define CASE_MLE_PEAK_MEMORY_PERCENT 75
+#endif
+
+/*
+ * Output of a case. It is written to a temporary file,
+ * only the head and the tail of it are kept for the output panel.
+ */
+class CaseOutputFile {
+public:
+    CaseOutputFile():
+        mFile{QDir::tempPath()+QDir::separator()+"redpanda_case_XXXXXX.out"},
+        mSize{0}
+    {
+        mFile.setAutoRemove(false);
+        mFile.open();
+    }
+    CaseOutputFile(const CaseOutputFile&)=delete;
+    CaseOutputFile& operator=(const CaseOutputFile&)=delete;
+
+    //returns the part of data that is in the head
+    QByteArray append(const QByteArray& data) {
+        mSize += data.length();
+        if (!mFile.isOpen()) {
+            //can't spill, keep all of it
+            mHead.append(data);
+            return data;
+        }
+        mFile.write(data);
+        int headLength = std::min<qint64>(CASE_OUTPUT_PREVIEW_SIZE - mHead.length(), data.length());
+        mHead.append(data.constData(), headLength);
+        if (headLength < data.length()) {
+            mTail.append(data.constData() + headLength, data.length() - headLength);
+            if (mTail.length() > 2 * CASE_OUTPUT_PREVIEW_SIZE)
+                mTail.remove(0, mTail.length() - CASE_OUTPUT_PREVIEW_SIZE);
+        }
+        return data.left(headLength);
+    }
+    bool truncated() const {
+        return mSize > mHead.length();
+    }
+    qint64 size() const {
+        return mSize;
+    }
+    const QByteArray& head() const {
+        return mHead;
+    }
+    QByteArray tail() const {
+        QByteArray tail = mTail.right(CASE_OUTPUT_PREVIEW_SIZE);
+        //start from a whole line
+        int pos = tail.indexOf('\n');
+        if (pos >= 0 && mSize - mHead.length() > tail.length())
+            tail.remove(0, pos + 1);
+        return tail;
+    }
+    //the file is kept after this
+    QString close() {
+        if (!mFile.isOpen())
+            return QString();
+        mFile.close();
+        return mFile.fileName();
+    }
+    void remove() {
+        if (mFile.isOpen())
+            mFile.remove();
+    }
+private:
+    QTemporaryFile mFile;
+    QByteArray mHead;
+    QByteArray mTail;
+    qint64 mSize;
+};
 
 OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStringList& arguments, const QString& workDir,
                                            const QVector<POJProblemCase>& problemCases, QObject *parent):
     Runner(filename,arguments,workDir,parent),
     mExecTimeout(0),
-    mMemoryLimit(0)
+    mMemoryLimit(0),
+    mJobs(1),
+#ifdef Q_OS_LINUX
+    mLimitAddressSpace(true),
+#endif
+    mReportingCase(0)
 {
     mProblemCases = problemCases;
     mBufferSize = 8192;
@@ -41,7 +131,12 @@ OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStrin
                                            POJProblemCase problemCase, QObject *parent):
     Runner(filename,arguments,workDir,parent),
     mExecTimeout(0),
-    mMemoryLimit(0)
+    mMemoryLimit(0),
+    mJobs(1),
+#ifdef Q_OS_LINUX
+    mLimitAddressSpace(true),
+#endif
+    mReportingCase(0)
 {
     mProblemCases.append(problemCase);
     mBufferSize = 8192;
@@ -51,25 +146,41 @@ OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStrin
 
 void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
 {
-    emit caseStarted(problemCase->getId(),index, mProblemCases.count());
-    auto action = finally([this,&index, &problemCase]{
-        emit caseFinished(problemCase->getId(), index, mProblemCases.count());
+    QString caseId = problemCase->getId();
+    int total = mProblemCases.count();
+    reportCaseEvent(index, [this, caseId, index, total]{
+        emit caseStarted(caseId, index, total);
     });
-    QProcess process;
-    bool errorOccurred = false;
-    QByteArray readed;
-    QByteArray buffer;
-    QByteArray output;
-    int noOutputTime = 0;
-    QElapsedTimer elapsedTimer;
-    bool execTimeouted = false;
-    process.setProgram(mFilename);
-    process.setArguments(mArguments);
-    process.setWorkingDirectory(mWorkDir);
+    auto action = finally([this, caseId, index, total]{
+        reportCaseEvent(index, [this, caseId, index, total]{
+            emit caseFinished(caseId, index, total);
+        }, true);
+    });
+    QProcessEnvironment env = caseEnvironment();
+    if (pSettings->executor().redirectStderrToToolLog()) {
+        QString header = "\n"+tr("--- stderr from %1 ---").arg(problemCase->name)+"\n";
+        reportCaseEvent(index, [this, header]{ emit logStderrOutput(header); });
+    }
+    problemCase->output.clear();
+    if (!problemCase->outputFileName.isEmpty()) {
+        QFile::remove(problemCase->outputFileName);
+        problemCase->outputFileName.clear();
+    }
+    problemCase->outputHeadLines = -1;
+    problemCase->runCompleted = false;
+    CaseOutputFile caseOutput;
+#ifdef Q_OS_LINUX
+    runCaseWithLimits(index, problemCase, env, caseOutput);
+#else
+    runCaseWithQProcess(index, problemCase, env, caseOutput);
+#endif
+}
+
+QProcessEnvironment OJProblemCasesRunner::caseEnvironment()
+{
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     QString path = env.value("PATH");
     QStringList pathAdded;
-    bool writeChannelClosed = false;
     if (pSettings->compilerSets().defaultSet()) {
         foreach(const QString& dir, pSettings->compilerSets().defaultSet()->binDirs()) {
             pathAdded.append(dir);
@@ -82,10 +193,167 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         path = pathAdded.join(PATH_SEPARATOR);
     }
     env.insert("PATH",path);
-    process.setProcessEnvironment(env);
-    if (pSettings->executor().redirectStderrToToolLog()) {
-        emit logStderrOutput("\n"+tr("--- stderr from %1 ---").arg(problemCase->name)+"\n");
+    return env;
+}
+
+bool OJProblemCasesRunner::checkCaseLimits(int index, POJProblemCase problemCase, bool timeLimitExceeded, bool memoryLimitExceeded)
+{
+    QString caseId = problemCase->getId();
+    if (timeLimitExceeded) {
+        problemCase->output = tr("Time limit exceeded!");
+    } else if (memoryLimitExceeded
+               || (mMemoryLimit>0 && problemCase->runningMemory>mMemoryLimit)) {
+        problemCase->output = tr("Memory limit exceeded!");
     } else {
+        return false;
+    }
+    QString newOutput = problemCase->output;
+    reportCaseEvent(index, [this, caseId, newOutput]{ emit resetOutput(caseId, newOutput); });
+    return true;
+}
+
+void OJProblemCasesRunner::appendCaseOutput(int index, const QString &caseId, CaseOutputFile &caseOutput, const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+    //once the head is full, output is only written to the file
+    QByteArray shown = caseOutput.append(data);
+    if (shown.isEmpty())
+        return;
+    QString newOutput = QString::fromLocal8Bit(shown);
+    reportCaseEvent(index, [this, caseId, newOutput]{ emit newOutputGetted(caseId, newOutput); });
+}
+
+void OJProblemCasesRunner::finishCaseOutput(int index, POJProblemCase problemCase, CaseOutputFile &caseOutput)
+{
+    QString caseId = problemCase->getId();
+    problemCase->outputFileName = caseOutput.close();
+    if (!caseOutput.truncated()) {
+        problemCase->output = QString::fromLocal8Bit(caseOutput.head());
+        return;
+    }
+    QString head = QString::fromLocal8Bit(caseOutput.head());
+    QByteArray tail = caseOutput.tail();
+    if (!head.endsWith('\n'))
+        head += '\n';
+    problemCase->outputHeadLines = head.count('\n');
+    problemCase->output = head
+            + tr("...... %1 bytes omitted, open the output file to see all of it ......")
+              .arg(caseOutput.size() - caseOutput.head().length() - tail.length())
+            + '\n' + QString::fromLocal8Bit(tail);
+    QString newOutput = problemCase->output;
+    reportCaseEvent(index, [this, caseId, newOutput]{ emit resetOutput(caseId, newOutput); });
+}
+
+#ifdef Q_OS_LINUX
+void OJProblemCasesRunner::runCaseWithLimits(int index, POJProblemCase problemCase, const QProcessEnvironment &env,
+                                             CaseOutputFile &caseOutput)
+{
+    QString caseId = problemCase->getId();
+    bool redirectStderr = pSettings->executor().redirectStderrToToolLog();
+    CaseProcess process;
+    process.setProgram(mFilename);
+    process.setArguments(mArguments);
+    process.setWorkingDirectory(mWorkDir);
+    process.setEnvironment(env);
+    process.setMergeStderr(!redirectStderr);
+    process.setLauncher(mLauncher);
+    if (mExecTimeout>0)
+        process.setCpuTimeLimit(mExecTimeout);
+    if (mMemoryLimit>0 && mLimitAddressSpace)
+        process.setAddressSpaceLimit(mMemoryLimit + CASE_ADDRESS_SPACE_SLACK);
+    //the input file is the program's stdin, it's not read by the IDE
+    bool inputFromFile = fileExists(problemCase->inputFileName);
+    if (inputFromFile)
+        process.setStandardInputFile(problemCase->inputFileName);
+    if (!process.start()) {
+        reportRunError(index, tr("The runner process '%1' failed to start.").arg(mFilename)
+                       + " " + process.errorString());
+        return;
+    }
+    if (!inputFromFile)
+        process.write(problemCase->input.toLocal8Bit());
+    process.closeWriteChannel();
+
+    QByteArray buffer;
+    int noOutputTime = 0;
+    bool wallTimeouted = false;
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    while (true) {
+        bool finished = process.waitForFinished(mWaitForFinishTime);
+        if (redirectStderr) {
+            QString s = QString::fromLocal8Bit(process.readAllStandardError());
+            if (!s.isEmpty())
+                reportCaseEvent(index, [this, s]{ emit logStderrOutput(s); });
+        }
+        buffer += process.readAllStandardOutput();
+        if (finished)
+            break;
+        //cpu time is limited by RLIMIT_CPU, this catches programs that sleep or wait for input
+        if (mExecTimeout>0 && elapsedTimer.elapsed() > mExecTimeout * 2 + CASE_WALL_TIME_SLACK)
+            wallTimeouted = true;
+        if (mStop || wallTimeouted) {
+            process.kill();
+            while (!process.waitForFinished(-1)) {
+                //what's left in the pipes of a killed program is dropped
+                process.readAllStandardOutput();
+                process.readAllStandardError();
+            }
+            break;
+        }
+        if (buffer.length()>=mBufferSize || noOutputTime > mOutputRefreshTime) {
+            appendCaseOutput(index, caseId, caseOutput, buffer);
+            buffer.clear();
+            noOutputTime = 0;
+        } else {
+            noOutputTime += mWaitForFinishTime;
+        }
+    }
+    problemCase->runningTime = process.cpuTime();
+    problemCase->runningMemory = process.peakMemory();
+    bool timeLimitExceeded = wallTimeouted
+            || process.terminationSignal() == SIGXCPU
+            || (mExecTimeout>0 && process.cpuTime()>mExecTimeout);
+    int termSignal = process.terminationSignal();
+    //allocations fail before the peak rss reaches the limit, the program then aborts (bad_alloc) or crashes
+    bool memoryLimitExceeded = mMemoryLimit>0 && mLimitAddressSpace
+            && (termSignal == SIGABRT || termSignal == SIGSEGV || termSignal == SIGBUS)
+            && problemCase->runningMemory * 100 >= mMemoryLimit * CASE_MLE_PEAK_MEMORY_PERCENT;
+    if (checkCaseLimits(index, problemCase, timeLimitExceeded, memoryLimitExceeded)) {
+        caseOutput.remove();
+        return;
+    }
+    appendCaseOutput(index, caseId, caseOutput, buffer);
+    finishCaseOutput(index, problemCase, caseOutput);
+    problemCase->runCompleted = !mStop && termSignal == 0;
+    if (!mStop && termSignal != 0) {
+        //keep what the program printed before it crashed
+        if (!problemCase->output.isEmpty() && !problemCase->output.endsWith('\n'))
+            problemCase->output += '\n';
+        problemCase->output += tr("Crashed: %1").arg(QString::fromLocal8Bit(strsignal(termSignal)));
+        QString newOutput = problemCase->output;
+        reportCaseEvent(index, [this, caseId, newOutput]{ emit resetOutput(caseId, newOutput); });
+    }
+}
+#else
+void OJProblemCasesRunner::runCaseWithQProcess(int index, POJProblemCase problemCase, const QProcessEnvironment &env,
+                                               CaseOutputFile &caseOutput)
+{
+    QString caseId = problemCase->getId();
+    QProcess process;
+    bool errorOccurred = false;
+    QByteArray readed;
+    QByteArray buffer;
+    int noOutputTime = 0;
+    QElapsedTimer elapsedTimer;
+    bool execTimeouted = false;
+    bool writeChannelClosed = false;
+    process.setProgram(mFilename);
+    process.setArguments(mArguments);
+    process.setWorkingDirectory(mWorkDir);
+    process.setProcessEnvironment(env);
+    if (!pSettings->executor().redirectStderrToToolLog()) {
         process.setProcessChannelMode(QProcess::MergedChannels);
         process.setReadChannel(QProcess::StandardOutput);
     }
@@ -94,7 +362,9 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
                 [&](){
         errorOccurred= true;
     });
-    problemCase->output.clear();
+    bool inputFromFile = fileExists(problemCase->inputFileName);
+    if (inputFromFile)
+        process.setStandardInputFile(problemCase->inputFileName);
     process.start();
     process.waitForStarted(5000);
 #ifdef Q_OS_WIN
@@ -103,11 +373,8 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         hProcess = OpenProcess(PROCESS_ALL_ACCESS,FALSE,process.processId());
     }
 #endif
-    if (process.state()==QProcess::Running) {
-        if (fileExists(problemCase->inputFileName))
-            process.write(readFileToByteArray(problemCase->inputFileName));
-        else
-            process.write(problemCase->input.toLocal8Bit());
+    if (process.state()==QProcess::Running && !inputFromFile) {
+        process.write(problemCase->input.toLocal8Bit());
         process.waitForFinished(0);
     }
 
@@ -137,16 +404,14 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         if (pSettings->executor().redirectStderrToToolLog()) {
             QString s = QString::fromLocal8Bit(process.readAllStandardError());
             if (!s.isEmpty())
-                emit logStderrOutput(s);
+                reportCaseEvent(index, [this, s]{ emit logStderrOutput(s); });
         }
-        readed = process.read(mBufferSize);
+        //take all of it, so that it isn't piled up in QProcess
+        readed = process.readAll();
         buffer += readed;
         if (buffer.length()>=mBufferSize || noOutputTime > mOutputRefreshTime) {
-            if (!buffer.isEmpty()) {
-                emit newOutputGetted(problemCase->getId(),QString::fromLocal8Bit(buffer));
-                output.append(buffer);
-                buffer.clear();
-            }
+            appendCaseOutput(index, caseId, caseOutput, buffer);
+            buffer.clear();
             noOutputTime = 0;
         } else {
             noOutputTime += mWaitForFinishTime;
@@ -174,42 +439,38 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         }
     }
 #endif
-    if (execTimeouted) {
-        problemCase->output = tr("Time limit exceeded!");
-        emit resetOutput(problemCase->getId(), problemCase->output);
-    } else if (mMemoryLimit>0 && problemCase->runningMemory>mMemoryLimit) {
-        problemCase->output = tr("Memory limit exceeded!");
-        emit resetOutput(problemCase->getId(), problemCase->output);
+    if (checkCaseLimits(index, problemCase, execTimeouted)) {
+        caseOutput.remove();
     } else {
         if (pSettings->executor().redirectStderrToToolLog()) {
             QString s = QString::fromLocal8Bit(process.readAllStandardError());
             if (!s.isEmpty())
-                emit logStderrOutput(s);
+                reportCaseEvent(index, [this, s]{ emit logStderrOutput(s); });
         }
         if (process.state() == QProcess::ProcessState::NotRunning)
             buffer += process.readAll();
-        emit newOutputGetted(problemCase->getId(),QString::fromLocal8Bit(buffer));
-        output.append(buffer);
-        problemCase->output = QString::fromLocal8Bit(output);
+        appendCaseOutput(index, caseId, caseOutput, buffer);
+        finishCaseOutput(index, problemCase, caseOutput);
+        problemCase->runCompleted = !mStop && !errorOccurred;
 
         if (errorOccurred) {
             //qDebug()<<"process error:"<<process.error();
             switch (process.error()) {
             case QProcess::FailedToStart:
-                emit runErrorOccurred(tr("The runner process '%1' failed to start.").arg(mFilename));
+                reportRunError(index, tr("The runner process '%1' failed to start.").arg(mFilename));
                 break;
     //        case QProcess::Crashed:
     //            if (!mStop)
     //                emit runErrorOccurred(tr("The runner process crashed after starting successfully."));
     //            break;
             case QProcess::Timedout:
-                emit runErrorOccurred(tr("The last waitFor...() function timed out."));
+                reportRunError(index, tr("The last waitFor...() function timed out."));
                 break;
             case QProcess::WriteError:
-                emit runErrorOccurred(tr("An error occurred when attempting to write to the runner process."));
+                reportRunError(index, tr("An error occurred when attempting to write to the runner process."));
                 break;
             case QProcess::ReadError:
-                emit runErrorOccurred(tr("An error occurred when attempting to read from the runner process."));
+                reportRunError(index, tr("An error occurred when attempting to read from the runner process."));
                 break;
             default:
                 break;
@@ -217,6 +478,7 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         }
     }
 }
+#endif
 
 void OJProblemCasesRunner::run()
 {
@@ -224,12 +486,78 @@ void OJProblemCasesRunner::run()
     auto action = finally([this]{
         emit terminated();
     });
-    for (int i=0; i < mProblemCases.size(); i++) {
-        if (mStop)
-            break;
+    int count = mProblemCases.size();
+    mReportingCase = 0;
+    mPendingCaseEvents = QVector<QList<CaseEvent>>(count);
+    mCaseReportFinished = QVector<bool>(count, false);
+#ifdef Q_OS_LINUX
+    QString launcher = includeTrailingPathDelimiter(pSettings->dirs().appLibexecDir()) + CONSOLE_PAUSER;
+    mLauncher = fileExists(launcher) ? launcher : QString();
+    //sanitizers reserve terabytes of address space
+    QByteArray program = readFileToByteArray(mFilename);
+    mLimitAddressSpace = !program.contains("__asan_init")
+            && !program.contains("__hwasan_init")
+            && !program.contains("__tsan_init")
+            && !program.contains("__msan_init");
+#endif
+    if (mJobs <= 1 || count <= 1) {
+        for (int i=0; i < count; i++) {
+            if (mStop)
+                break;
+            POJProblemCase problemCase = mProblemCases[i];
+            runCase(i,problemCase);
+        }
+        return;
+    }
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::min(mJobs, count));
+    for (int i=0; i < count; i++) {
         POJProblemCase problemCase = mProblemCases[i];
-        runCase(i,problemCase);
+        pool.start(QRunnable::create([this, i, problemCase](){
+            if (!mStop)
+                runCase(i, problemCase);
+        }));
     }
+    pool.waitForDone();
+}
+
+void OJProblemCasesRunner::reportCaseEvent(int index, const CaseEvent &event, bool caseFinished)
+{
+    QMutexLocker locker(&mReportMutex);
+    //events of a case are held back until all cases before it are reported
+    if (index != mReportingCase) {
+        mPendingCaseEvents[index].append(event);
+        if (caseFinished)
+            mCaseReportFinished[index] = true;
+        return;
+    }
+    event();
+    if (!caseFinished)
+        return;
+    mReportingCase++;
+    while (mReportingCase < mPendingCaseEvents.count()) {
+        foreach (const CaseEvent& pendingEvent, mPendingCaseEvents[mReportingCase])
+            pendingEvent();
+        mPendingCaseEvents[mReportingCase].clear();
+        if (!mCaseReportFinished[mReportingCase])
+            break;
+        mReportingCase++;
+    }
+}
+
+void OJProblemCasesRunner::reportRunError(int index, const QString &reason)
+{
+    reportCaseEvent(index, [this, reason]{ emit runErrorOccurred(reason); });
+}
+
+int OJProblemCasesRunner::jobs() const
+{
+    return mJobs;
+}
+
+void OJProblemCasesRunner::setJobs(int newJobs)
+{
+    mJobs = newJobs;
 }
 
 int OJProblemCasesRunner::execTimeout() const
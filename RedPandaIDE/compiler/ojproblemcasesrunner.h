@@ -18,9 +18,13 @@
 #define OJPROBLEMCASESRUNNER_H
 
 #include "runner.h"
+#include <QMutex>
+#include <QProcessEnvironment>
 #include <QVector>
+#include <functional>
 #include "../problems/ojproblemset.h"
 
+class CaseOutputFile;
 class OJProblemCasesRunner : public Runner
 {
     Q_OBJECT
@@ -52,6 +56,10 @@ public:
     bool includeOutputFromStderr() const;
     void setIncludeOutputFromStderr(bool newIncludeOutputFromStderr);
 
+    //number of cases run at the same time
+    int jobs() const;
+    void setJobs(int newJobs);
+
 signals:
     void caseStarted(const QString &caseId, int current, int total);
     void caseFinished(const QString &caseId, int current, int total);
@@ -59,7 +67,21 @@ signals:
     void resetOutput(const QString &caseId, const QString &newOutputLine);
     void logStderrOutput(const QString& msg);
 private:
+    using CaseEvent = std::function<void()>;
     void runCase(int index, POJProblemCase problemCase);
+#ifdef Q_OS_LINUX
+    void runCaseWithLimits(int index, POJProblemCase problemCase, const QProcessEnvironment& env,
+                           CaseOutputFile& caseOutput);
+#else
+    void runCaseWithQProcess(int index, POJProblemCase problemCase, const QProcessEnvironment& env,
+                             CaseOutputFile& caseOutput);
+#endif
+    QProcessEnvironment caseEnvironment();
+    bool checkCaseLimits(int index, POJProblemCase problemCase, bool timeLimitExceeded, bool memoryLimitExceeded = false);
+    void appendCaseOutput(int index, const QString& caseId, CaseOutputFile& caseOutput, const QByteArray& data);
+    void finishCaseOutput(int index, POJProblemCase problemCase, CaseOutputFile& caseOutput);
+    void reportCaseEvent(int index, const CaseEvent& event, bool caseFinished = false);
+    void reportRunError(int index, const QString& reason);
 private:
     QVector<POJProblemCase> mProblemCases;
 
@@ -72,6 +94,15 @@ private:
     int mExecTimeout;
     size_t mMemoryLimit;
     bool mIncludeOutputFromStderr;
+    int mJobs;
+#ifdef Q_OS_LINUX
+    QString mLauncher;
+    bool mLimitAddressSpace;
+#endif
+    QMutex mReportMutex;
+    int mReportingCase;
+    QVector<QList<CaseEvent>> mPendingCaseEvents;
+    QVector<bool> mCaseReportFinished;
 };
 
 #endif // OJPROBLEMCASESRUNNER_H
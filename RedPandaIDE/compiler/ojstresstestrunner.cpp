@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ojstresstestrunner.h"
+#include "../problems/problemcasevalidator.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QProcess>
+#include <QThreadPool>
+
+//time limit (in milliseconds) of the generator and the brute force program
+#define STRESS_TEST_HELPER_TIMEOUT 10000
+//time (in milliseconds) between progress updates
+#define STRESS_TEST_PROGRESS_INTERVAL 500
+
+OJStressTestRunner::OJStressTestRunner(const QString &answerExecutable, const QString &generatorExecutable,
+                                       const QString &bruteForceExecutable, const QString &workDir,
+                                       QObject *parent):
+    Runner(answerExecutable, QStringList(), workDir, parent),
+    mGeneratorExecutable(generatorExecutable),
+    mBruteForceExecutable(bruteForceExecutable),
+    mExecTimeout(0),
+    mJobs(1),
+    mValidateType(ProblemCaseValidateType::Exact),
+    mNextIteration(0),
+    mFinishedIterations(0),
+    mFinished(false)
+{
+}
+
+void OJStressTestRunner::run()
+{
+    emit started();
+    auto action = finally([this]{
+        emit terminated();
+    });
+    emit logOutput(tr("Stress testing with %1 jobs...").arg(mJobs));
+    QElapsedTimer timer;
+    timer.start();
+    QThreadPool pool;
+    pool.setMaxThreadCount(mJobs);
+    for (int i=0;i<mJobs;i++) {
+        pool.start(QRunnable::create([this](){
+            runIterations();
+        }));
+    }
+    while (!pool.waitForDone(STRESS_TEST_PROGRESS_INTERVAL)) {
+        qint64 iterations = mFinishedIterations;
+        emit progressUpdated(iterations, iterations * 1000.0 / std::max<qint64>(timer.elapsed(), 1));
+    }
+    qint64 iterations = mFinishedIterations;
+    emit progressUpdated(iterations, iterations * 1000.0 / std::max<qint64>(timer.elapsed(), 1));
+}
+
+void OJStressTestRunner::runIterations()
+{
+    ProblemCaseValidator validator;
+    while (!mStop && !mFinished) {
+        qint64 iteration = mNextIteration++;
+        QByteArray input;
+        QByteArray expected;
+        QByteArray output;
+        QString errorMessage;
+        if (!runProgram(mGeneratorExecutable, QStringList{QString::number(iteration)}, QByteArray(),
+                        STRESS_TEST_HELPER_TIMEOUT, input, errorMessage)) {
+            stopWithError(tr("Generator failed in iteration %1: %2").arg(iteration).arg(errorMessage));
+            return;
+        }
+        if (!runProgram(mBruteForceExecutable, QStringList(), input,
+                        STRESS_TEST_HELPER_TIMEOUT, expected, errorMessage)) {
+            stopWithError(tr("Brute force program failed in iteration %1: %2").arg(iteration).arg(errorMessage));
+            return;
+        }
+        //a crashed or timeouted answer is a mismatch, too
+        bool answerFinished = runProgram(mFilename, QStringList(), input,
+                                         mExecTimeout > 0 ? mExecTimeout : STRESS_TEST_HELPER_TIMEOUT,
+                                         output, errorMessage);
+        if (mStop || mFinished)
+            return;
+        POJProblemCase problemCase = std::make_shared<OJProblemCase>();
+        problemCase->expected = QString::fromLocal8Bit(expected);
+        problemCase->output = QString::fromLocal8Bit(output);
+        if (answerFinished && validator.validate(problemCase, mValidateType)) {
+            mFinishedIterations++;
+            continue;
+        }
+        QMutexLocker locker(&mResultMutex);
+        //only the first mismatch is reported
+        if (mFinished)
+            return;
+        mFinished = true;
+        if (!answerFinished)
+            problemCase->output = errorMessage;
+        emit mismatchFound(iteration, QString::fromLocal8Bit(input), problemCase->expected, problemCase->output);
+        return;
+    }
+}
+
+bool OJStressTestRunner::runProgram(const QString &program, const QStringList &arguments, const QByteArray &input,
+                                    int timeout, QByteArray &output, QString &errorMessage)
+{
+    QProcess process;
+    process.setProgram(program);
+    process.setArguments(arguments);
+    process.setWorkingDirectory(mWorkDir);
+    process.setStandardErrorFile(QProcess::nullDevice());
+    process.start();
+    if (!process.waitForStarted(5000)) {
+        errorMessage = tr("The runner process '%1' failed to start.").arg(program);
+        return false;
+    }
+    process.write(input);
+    process.closeWriteChannel();
+    if (!process.waitForFinished(timeout)) {
+        process.kill();
+        process.waitForFinished(-1);
+        errorMessage = tr("Time limit exceeded!");
+        return false;
+    }
+    output = process.readAllStandardOutput();
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        errorMessage = tr("'%1' exited with code %2.").arg(extractFileName(program)).arg(process.exitCode());
+        return false;
+    }
+    return true;
+}
+
+void OJStressTestRunner::stopWithError(const QString &reason)
+{
+    QMutexLocker locker(&mResultMutex);
+    if (mFinished)
+        return;
+    mFinished = true;
+    emit runErrorOccurred(reason);
+}
+
+int OJStressTestRunner::execTimeout() const
+{
+    return mExecTimeout;
+}
+
+void OJStressTestRunner::setExecTimeout(int newExecTimeout)
+{
+    mExecTimeout = newExecTimeout;
+}
+
+int OJStressTestRunner::jobs() const
+{
+    return mJobs;
+}
+
+void OJStressTestRunner::setJobs(int newJobs)
+{
+    mJobs = std::max(1, newJobs);
+}
+
+ProblemCaseValidateType OJStressTestRunner::validateType() const
+{
+    return mValidateType;
+}
+
+void OJStressTestRunner::setValidateType(ProblemCaseValidateType newValidateType)
+{
+    mValidateType = newValidateType;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef OJSTRESSTESTRUNNER_H
+#define OJSTRESSTESTRUNNER_H
+
+#include "runner.h"
+#include <QMutex>
+#include <atomic>
+#include "../utils.h"
+
+/*
+ * Stress test of a problem's answer:
+ * inputs made by the generator are fed to the brute force program and to the answer,
+ * until their outputs don't match.
+ * The generator gets the iteration number as its only argument, to seed its random numbers.
+ * The three programs are compiled by the compiler manager before the runner starts.
+ */
+class OJStressTestRunner : public Runner
+{
+    Q_OBJECT
+public:
+    explicit OJStressTestRunner(const QString& answerExecutable, const QString& generatorExecutable,
+                                const QString& bruteForceExecutable, const QString& workDir,
+                                QObject *parent = nullptr);
+    OJStressTestRunner(const OJStressTestRunner&)=delete;
+    OJStressTestRunner& operator=(const OJStressTestRunner&)=delete;
+
+    int execTimeout() const;
+    void setExecTimeout(int newExecTimeout);
+
+    //number of iterations run at the same time
+    int jobs() const;
+    void setJobs(int newJobs);
+
+    ProblemCaseValidateType validateType() const;
+    void setValidateType(ProblemCaseValidateType newValidateType);
+
+signals:
+    void logOutput(const QString& msg);
+    void progressUpdated(qint64 iterations, double iterationsPerSecond);
+    void mismatchFound(qint64 iteration, const QString& input, const QString& expected, const QString& output);
+private:
+    void runIterations();
+    bool runProgram(const QString& program, const QStringList& arguments, const QByteArray& input,
+                    int timeout, QByteArray& output, QString& errorMessage);
+    void stopWithError(const QString& reason);
+
+    // QThread interface
+protected:
+    void run() override;
+private:
+    QString mGeneratorExecutable;
+    QString mBruteForceExecutable;
+    int mExecTimeout;
+    int mJobs;
+    ProblemCaseValidateType mValidateType;
+    std::atomic<qint64> mNextIteration;
+    std::atomic<qint64> mFinishedIterations;
+    std::atomic_bool mFinished;
+    QMutex mResultMutex;
+};
+
+#endif // OJSTRESSTESTRUNNER_H
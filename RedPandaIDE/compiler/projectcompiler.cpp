@@ -26,6 +26,8 @@
 #include "utils/parsearg.h"
 
 #include <QDir>
+#include <QStandardPaths>
+#include <QThreadPool>
 
 ProjectCompiler::ProjectCompiler(std::shared_ptr<Project> project):
     Compiler("",false),
@@ -61,6 +63,7 @@ void ProjectCompiler::createStandardMakeFile()
     QString exeCommand = escapeArgumentForMakefileRecipe(executable, false);
     writeln(file, exeTarget + ": $(OBJ)\n");
     if (!mOnlyCheckSyntax) {
+        writeln(file, "\t@echo " LINK_PHASE_MARKER);
         if (mProject->options().isCpp) {
             writeln(file, "\t$(CXX) $(LINKOBJ) -o " + exeCommand + " $(LIBS)");
         } else
@@ -77,6 +80,7 @@ void ProjectCompiler::createStaticMakeFile()
     QString libTarget = escapeFilenameForMakefileTarget(libFilename);
     QString libCommand = escapeArgumentForMakefileRecipe(libFilename, false);
     writeln(file, libTarget + ": $(OBJ)");
+    writeln(file, "\t@echo " LINK_PHASE_MARKER);
     writeln(file, "\tar r " + libCommand + " $(LINKOBJ)");
     writeln(file, "\tranlib " + libCommand);
     writeMakeObjFilesRules(file);
@@ -91,6 +95,7 @@ void ProjectCompiler::createDynamicMakeFile()
     QString dynamicLibTarget = escapeFilenameForMakefileTarget(dynamicLibFilename);
     QString dynamicLibCommand = escapeArgumentForMakefileRecipe(dynamicLibFilename, false);
     writeln(file, dynamicLibTarget + ": $(DEF) $(OBJ)");
+    writeln(file, "\t@echo " LINK_PHASE_MARKER);
     if (genModuleDef) {
         if (mProject->options().isCpp) {
             writeln(file, "\t$(CXX) -mdll $(LINKOBJ) -o " + dynamicLibCommand + " $(LIBS) $(DEF) -Wl,--output-def,$(OUTPUT_DEF),--out-implib,$(STATIC)");
@@ -175,6 +180,7 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
     QStringList LinkObjects;
     QStringList cleanObjects;
     QStringList moduleDefines;
+    bool splitDebugInfo = useSplitDebugInfo();
 
     genModuleDef = false;
 
@@ -194,12 +200,20 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
                 QString relativeObjFile = extractRelativePath(mProject->directory(), changeFileExt(fullObjFile, OBJ_EXT));
                 objects << relativeObjFile;
                 cleanObjects << localizePath(relativeObjFile);
+                if (fileType != FileType::GAS)
+                    cleanObjects << localizePath(changeFileExt(relativeObjFile, DEP_EXT));
+                if (fileType != FileType::GAS && splitDebugInfo)
+                    cleanObjects << localizePath(changeFileExt(relativeObjFile, DWO_EXT));
                 if (unit->link()) {
                     LinkObjects << relativeObjFile;
                 }
             } else {
                 objects << changeFileExt(relativeName, OBJ_EXT);
                 cleanObjects << localizePath(changeFileExt(relativeName, OBJ_EXT));
+                if (fileType != FileType::GAS)
+                    cleanObjects << localizePath(changeFileExt(relativeName, DEP_EXT));
+                if (fileType != FileType::GAS && splitDebugInfo)
+                    cleanObjects << localizePath(changeFileExt(relativeName, DWO_EXT));
                 if (unit->link())
                     LinkObjects << changeFileExt(relativeName, OBJ_EXT);
             }
@@ -371,10 +385,11 @@ void ProjectCompiler::writeMakeClean(QFile &file)
 void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
 {
     PCppParser parser = mProject->cppParser();
-    QString precompileStr;
+    bool usePCH = mProject->options().usePrecompiledHeader
+            && fileExists(mProject->options().precompiledHeader);
+    QStringList depFiles;
 
-    QList<PProjectUnit> projectUnits=mProject->unitList();
-    foreach(const PProjectUnit &unit, projectUnits) {
+    foreach(const PProjectUnit &unit, mProject->unitList()) {
         if (!unit->compile())
             continue;
         FileType fileType = getFileType(unit->fileName());
@@ -386,44 +401,27 @@ void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
         QString shortFileName = extractRelativePath(mProject->makeFileName(),unit->fileName());
 
         writeln(file);
+        //header prerequisites come from the dependency files generated by the compiler
         QString objStr = escapeFilenameForMakefilePrerequisite(shortFileName);
-        // if we have scanned it, use scanned info
-        if (parser && parser->fileScanned(unit->fileName())) {
-            QSet<QString> includedFiles = parser->getIncludedFiles(unit->fileName());
-            foreach(const PProjectUnit &unit2, projectUnits) {
-                if (unit2==unit)
-                    continue;
-                if (includedFiles.contains(unit2->fileName())) {
-                    if (mProject->options().usePrecompiledHeader &&
-                           unit2->fileName() == mProject->options().precompiledHeader)
-                        precompileStr = " $(PCH) ";
-                    else {
-                        QString prereq = extractRelativePath(mProject->makeFileName(), unit2->fileName());
-                        objStr = objStr + ' ' + escapeFilenameForMakefilePrerequisite(prereq);
-                    }
-                }
-            }
-        } else {
-            foreach(const PProjectUnit &unit2, projectUnits) {
-                FileType fileType = getFileType(unit2->fileName());
-                if (fileType == FileType::CHeader || fileType==FileType::CppHeader) {
-                    QString prereq = extractRelativePath(mProject->makeFileName(), unit2->fileName());
-                    objStr = objStr + ' ' + escapeFilenameForMakefilePrerequisite(prereq);
-                }
-            }
-        }
+        QString precompileStr;
+        if (usePCH && parser && parser->fileScanned(unit->fileName())
+                && parser->getIncludedFiles(unit->fileName()).contains(mProject->options().precompiledHeader))
+            precompileStr = " $(PCH) ";
         QString objFileNameTarget;
         QString objFileNameCommand;
+        QString depFile;
         if (!mProject->options().folderForObjFiles.isEmpty()) {
             QString fullObjname = includeTrailingPathDelimiter(mProject->options().folderForObjFiles) +
                     extractFileName(unit->fileName());
             QString objectFile = extractRelativePath(mProject->makeFileName(), changeFileExt(fullObjname, OBJ_EXT));
             objFileNameTarget = escapeFilenameForMakefileTarget(objectFile);
             objFileNameCommand = escapeArgumentForMakefileRecipe(objectFile, false);
+            depFile = changeFileExt(objectFile, DEP_EXT);
         } else {
             QString objectFile = changeFileExt(shortFileName, OBJ_EXT);
             objFileNameTarget = escapeFilenameForMakefileTarget(objectFile);
             objFileNameCommand = escapeArgumentForMakefileRecipe(objectFile, false);
+            depFile = changeFileExt(objectFile, DEP_EXT);
         }
 
         objStr = objFileNameTarget + ": " + objStr + precompileStr;
@@ -437,68 +435,33 @@ void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
             writeln(file, '\t' + BuildCmd);
             // Or roll our own
         } else {
+            QStringList charsetArguments = getUnitCharsetArguments(unit);
             QString encodingStr;
-            if (compilerSet()->compilerType() != CompilerType::Clang && mProject->options().addCharset) {
-                QByteArray defaultSystemEncoding=pCharsetInfoManager->getDefaultSystemEncoding();
-                QByteArray encoding = mProject->options().execEncoding;
-                QByteArray targetEncoding;
-                QByteArray sourceEncoding;
-                if ( encoding == ENCODING_SYSTEM_DEFAULT || encoding.isEmpty()) {
-                    targetEncoding = defaultSystemEncoding;
-                } else if (encoding == ENCODING_UTF8_BOM) {
-                    targetEncoding = "UTF-8";
-                } else if (encoding == ENCODING_UTF16_BOM) {
-                    targetEncoding = "UTF-16";
-                } else if (encoding == ENCODING_UTF32_BOM) {
-                    targetEncoding = "UTF-32";
-                } else {
-                    targetEncoding = encoding;
-                }
-
-                if (unit->realEncoding().isEmpty()) {
-                    if (unit->encoding() == ENCODING_AUTO_DETECT) {
-                        Editor* editor = mProject->unitEditor(unit);
-                        if (editor && editor->fileEncoding()!=ENCODING_ASCII
-                                && editor->fileEncoding()!=targetEncoding) {
-                            sourceEncoding = editor->fileEncoding();
-                        } else {
-                            sourceEncoding = targetEncoding;
-                        }
-                    } else if (unit->encoding()==ENCODING_PROJECT) {
-                        sourceEncoding=mProject->options().encoding;
-                    } else if (unit->encoding()==ENCODING_SYSTEM_DEFAULT) {
-                        sourceEncoding = defaultSystemEncoding;
-                    } else if (unit->encoding()!=ENCODING_ASCII && !unit->encoding().isEmpty()) {
-                        sourceEncoding = unit->encoding();
-                    } else {
-                        sourceEncoding = targetEncoding;
-                    }
-                } else if (unit->realEncoding()==ENCODING_ASCII) {
-                    sourceEncoding = targetEncoding;
-                } else {
-                    sourceEncoding = unit->realEncoding();
-                }
-                if (sourceEncoding==ENCODING_SYSTEM_DEFAULT)
-                    sourceEncoding = defaultSystemEncoding;
-
-                if (QString::compare(sourceEncoding,targetEncoding,Qt::CaseInsensitive)!=0) {
-                    encodingStr = QString(" -finput-charset=%1 -fexec-charset=%2")
-                            .arg(QString(sourceEncoding),
-                                 QString(targetEncoding));
-                }
-            }
+            if (!charsetArguments.isEmpty())
+                encodingStr = " " + charsetArguments.join(" ");
 
             if (fileType==FileType::CSource || fileType==FileType::CppSource) {
+                //-MMD writes the dependency file next to the object file
                 if (unit->compileCpp())
-                    writeln(file, "\t$(CXX) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CXXFLAGS) " + encodingStr);
+                    writeln(file, "\t$(CXX) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CXXFLAGS) -MMD -MP " + encodingStr);
                 else
-                    writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) " + encodingStr);
+                    writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) -MMD -MP " + encodingStr);
+                depFiles.append(depFile);
             } else if (fileType==FileType::GAS) {
                 writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) " + encodingStr);
             }
         }
     }
 
+    if (!depFiles.isEmpty()) {
+        // missing dependency files (objects not built yet) are silently ignored
+        writeln(file);
+        QStringList depIncludes;
+        foreach (const QString& depFile, depFiles)
+            depIncludes.append(escapeFilenameForMakefileInclude(depFile));
+        writeln(file, "-include " + depIncludes.join(' '));
+    }
+
 #ifdef Q_OS_WIN
     if (!mProject->options().privateResource.isEmpty()) {
         // Concatenate all resource include directories
@@ -557,6 +520,70 @@ void ProjectCompiler::writeln(QFile &file, const QString &s)
     file.write("\n");
 }
 
+QStringList ProjectCompiler::getUnitCharsetArguments(const std::shared_ptr<ProjectUnit> &unit)
+{
+    QStringList result;
+    if (compilerSet()->compilerType() != CompilerType::Clang && mProject->options().addCharset) {
+        QByteArray defaultSystemEncoding=pCharsetInfoManager->getDefaultSystemEncoding();
+        QByteArray encoding = mProject->options().execEncoding;
+        QByteArray targetEncoding;
+        QByteArray sourceEncoding;
+        if ( encoding == ENCODING_SYSTEM_DEFAULT || encoding.isEmpty()) {
+            targetEncoding = defaultSystemEncoding;
+        } else if (encoding == ENCODING_UTF8_BOM) {
+            targetEncoding = "UTF-8";
+        } else if (encoding == ENCODING_UTF16_BOM) {
+            targetEncoding = "UTF-16";
+        } else if (encoding == ENCODING_UTF32_BOM) {
+            targetEncoding = "UTF-32";
+        } else {
+            targetEncoding = encoding;
+        }
+
+        if (unit->realEncoding().isEmpty()) {
+            if (unit->encoding() == ENCODING_AUTO_DETECT) {
+                Editor* editor = mProject->unitEditor(unit);
+                if (editor && editor->fileEncoding()!=ENCODING_ASCII
+                        && editor->fileEncoding()!=targetEncoding) {
+                    sourceEncoding = editor->fileEncoding();
+                } else {
+                    sourceEncoding = targetEncoding;
+                }
+            } else if (unit->encoding()==ENCODING_PROJECT) {
+                sourceEncoding=mProject->options().encoding;
+            } else if (unit->encoding()==ENCODING_SYSTEM_DEFAULT) {
+                sourceEncoding = defaultSystemEncoding;
+            } else if (unit->encoding()!=ENCODING_ASCII && !unit->encoding().isEmpty()) {
+                sourceEncoding = unit->encoding();
+            } else {
+                sourceEncoding = targetEncoding;
+            }
+        } else if (unit->realEncoding()==ENCODING_ASCII) {
+            sourceEncoding = targetEncoding;
+        } else {
+            sourceEncoding = unit->realEncoding();
+        }
+        if (sourceEncoding==ENCODING_SYSTEM_DEFAULT)
+            sourceEncoding = defaultSystemEncoding;
+
+        if (QString::compare(sourceEncoding,targetEncoding,Qt::CaseInsensitive)!=0) {
+            result << QString("-finput-charset=%1").arg(QString(sourceEncoding))
+                   << QString("-fexec-charset=%1").arg(QString(targetEncoding));
+        }
+    }
+    return result;
+}
+
+QString ProjectCompiler::getUnitObjectFile(const std::shared_ptr<ProjectUnit> &unit)
+{
+    if (!mProject->options().folderForObjFiles.isEmpty()) {
+        QString fullObjname = includeTrailingPathDelimiter(mProject->options().folderForObjFiles) +
+                extractFileName(unit->fileName());
+        return generateAbsolutePath(mProject->directory(), changeFileExt(fullObjname, OBJ_EXT));
+    }
+    return changeFileExt(unit->fileName(), OBJ_EXT);
+}
+
 bool ProjectCompiler::onlyClean() const
 {
     return mOnlyClean;
@@ -632,12 +659,201 @@ bool ProjectCompiler::prepareForCompile()
 
     mOutputFile = mProject->outputFilename();
 
+    mCacheMissedObjects.clear();
+    //object paths of custom makefiles are unknown, and split debug info (.dwo) is not cached
+    if (!mOnlyClean
+            && !(mProject->options().useCustomMakefile && !mProject->options().customMakefile.isEmpty())
+            && !useSplitDebugInfo())
+        mObjectCache = createObjectCache();
+
     log(tr("Processing makefile:"));
     log("--------");
     log(tr("- makefile processer: %1").arg(mCompiler));
+    QString linker = findFastLinker();
+    if (!linker.isEmpty() && mProject->options().type != ProjectType::StaticLib)
+        log(tr("- Linker: %1").arg(linker));
     QString command = escapeCommandForLog(mCompiler, mArguments);
     log(tr("- Command: %1").arg(command));
     log("");
 
     return true;
 }
+
+QStringList ProjectCompiler::getCCompileArguments(bool checkSyntax)
+{
+    QStringList result = Compiler::getCCompileArguments(checkSyntax);
+    if (!checkSyntax && useSplitDebugInfo())
+        result << "-gsplit-dwarf";
+    return result;
+}
+
+QStringList ProjectCompiler::getCppCompileArguments(bool checkSyntax)
+{
+    QStringList result = Compiler::getCppCompileArguments(checkSyntax);
+    if (!checkSyntax && useSplitDebugInfo())
+        result << "-gsplit-dwarf";
+    return result;
+}
+
+QStringList ProjectCompiler::getLibraryArguments(FileType fileType)
+{
+    QStringList result = Compiler::getLibraryArguments(fileType);
+    QString linker = findFastLinker();
+    if (!linker.isEmpty()) {
+        result << "-fuse-ld=" + linker;
+        //GNU ld can't build the index
+        if (useSplitDebugInfo())
+            result << "-Wl,--gdb-index";
+    }
+    return result;
+}
+
+QString ProjectCompiler::findFastLinker()
+{
+    if (!mProject->options().useFastLinker)
+        return QString();
+    CompilerType compilerType = compilerSet()->compilerType();
+    bool isClang = (compilerType == CompilerType::Clang);
+    if (!isClang && compilerType != CompilerType::GCC && compilerType != CompilerType::GCC_UTF8)
+        return QString();
+    int version = compilerSet()->mainVersion();
+    // linkers accepted by -fuse-ld, fastest first
+    QList<QPair<QString,QString>> linkers;
+    if (isClang || version >= 12)
+        linkers.append(qMakePair(QString("mold"), QString(MOLD_LINKER_PROGRAM)));
+    if (isClang || version >= 9)
+        linkers.append(qMakePair(QString("lld"), QString(LLD_LINKER_PROGRAM)));
+    linkers.append(qMakePair(QString("gold"), QString(GOLD_LINKER_PROGRAM)));
+    foreach (const auto& linker, linkers) {
+        if (linker.second.isEmpty())
+            continue;
+        if (!QStandardPaths::findExecutable(linker.second, compilerSet()->binDirs()).isEmpty()
+                || !QStandardPaths::findExecutable(linker.second).isEmpty())
+            return linker.first;
+    }
+    return QString();
+}
+
+bool ProjectCompiler::useSplitDebugInfo()
+{
+#ifdef Q_OS_WIN
+    return false;
+#else
+    if (!mProject->options().splitDebugInfo)
+        return false;
+    CompilerType compilerType = compilerSet()->compilerType();
+    if (compilerType != CompilerType::Clang && compilerType != CompilerType::GCC
+            && compilerType != CompilerType::GCC_UTF8)
+        return false;
+    QMap<QString, QString> compileOptions;
+    if (!mProject->options().compilerOptions.isEmpty()) {
+        compileOptions = mProject->options().compilerOptions;
+    } else {
+        compileOptions = compilerSet()->compileOptions();
+    }
+    return !compileOptions.value(CC_CMD_OPT_DEBUG_INFO).isEmpty();
+#endif
+}
+
+bool ProjectCompiler::beforeRunExtraCommand(int idx)
+{
+    //the only extra command is "make all" after "make clean" when rebuilding
+    if (idx==0 && mRebuild)
+        restoreObjectsFromCache();
+    return true;
+}
+
+bool ProjectCompiler::fetchOutputFromCache()
+{
+    if (!mRebuild)
+        restoreObjectsFromCache();
+    //make still links the target and builds the objects not in the cache
+    return false;
+}
+
+void ProjectCompiler::storeOutputToCache()
+{
+    if (!mObjectCache)
+        return;
+    foreach (const PCachedObject& object, mCacheMissedObjects) {
+        QFileInfo info(object->objectFile);
+        //store only objects that make rebuilt in this run
+        if (info.exists() && info.lastModified() != object->lastModified
+                && info.lastModified() >= QFileInfo(object->sourceFile).lastModified())
+            mObjectCache->store(object->key, object->objectFile);
+    }
+    mCacheMissedObjects.clear();
+    mObjectCache->prune();
+}
+
+void ProjectCompiler::restoreObjectsFromCache()
+{
+    if (!mObjectCache)
+        return;
+    QStringList cFlags = getCIncludeArguments() + getProjectIncludeArguments()
+            + getReflextiveArguments() + getCCompileArguments(false);
+    QStringList cxxFlags = getCppIncludeArguments() + getProjectIncludeArguments()
+            + getReflextiveArguments() + getCppCompileArguments(false);
+    QList<PCachedObject> candidates;
+    foreach (const PProjectUnit& unit, mProject->unitList()) {
+        if (!unit->compile() || (unit->overrideBuildCmd() && !unit->buildCmd().isEmpty()))
+            continue;
+        FileType fileType = getFileType(unit->fileName());
+        if (fileType!=FileType::CSource && fileType!=FileType::CppSource)
+            continue;
+        PCachedObject object = std::make_shared<CachedObject>();
+        object->sourceFile = unit->fileName();
+        object->objectFile = getUnitObjectFile(unit);
+        QFileInfo objectInfo(object->objectFile);
+        QFileInfo sourceInfo(object->sourceFile);
+        //up to date objects are left to make
+        if (objectInfo.exists() && objectInfo.lastModified() >= sourceInfo.lastModified())
+            continue;
+        if (objectInfo.exists())
+            object->lastModified = objectInfo.lastModified();
+        object->restored = false;
+        if (unit->compileCpp()) {
+            object->compiler = compilerSet()->cppCompiler();
+            object->flags = cxxFlags;
+        } else {
+            object->compiler = compilerSet()->CCompiler();
+            object->flags = cFlags;
+        }
+        object->flags += getUnitCharsetArguments(unit);
+        //restored objects need their dependency files, or header changes won't rebuild them
+        object->dependencyArguments = QStringList{
+                "-MMD", "-MP",
+                "-MF", changeFileExt(object->objectFile, DEP_EXT),
+                "-MQ", extractRelativePath(mProject->makeFileName(), object->objectFile)};
+        candidates.append(object);
+    }
+    if (candidates.isEmpty())
+        return;
+
+    log(tr("Looking up %1 object file(s) in the object cache...").arg(candidates.count()));
+    QString workingDir = mProject->directory();
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    foreach (const PCachedObject& object, candidates) {
+        pool.start(QRunnable::create([this, object, workingDir](){
+            object->key = computeObjectCacheKey(object->compiler, object->sourceFile,
+                                                object->flags + object->dependencyArguments,
+                                                QStringList{extractFileName(object->compiler)} + object->flags,
+                                                workingDir);
+            QString diagnostics;
+            if (!object->key.isEmpty())
+                object->restored = mObjectCache->fetch(object->key, object->objectFile, diagnostics);
+        }));
+    }
+    pool.waitForDone();
+
+    int restored = 0;
+    foreach (const PCachedObject& object, candidates) {
+        if (object->restored)
+            restored++;
+        else if (!object->key.isEmpty())
+            mCacheMissedObjects.append(object);
+    }
+    log(tr("- %1 object file(s) restored from the object cache.").arg(restored));
+    log("");
+}
@@ -20,8 +20,10 @@
 #include "compiler.h"
 #include <QObject>
 #include <QFile>
+#include <QDateTime>
 
 class Project;
+class ProjectUnit;
 class ProjectCompiler : public Compiler
 {
     Q_OBJECT
@@ -49,11 +51,35 @@ private:
     void writeln(QFile& file, const QString& s="");
     // Compiler interface
 private:
+    struct CachedObject {
+        QString sourceFile;
+        QString objectFile;
+        QString compiler;
+        QStringList flags;
+        QStringList dependencyArguments;
+        QDateTime lastModified;
+        QByteArray key;
+        bool restored;
+    };
+    using PCachedObject = std::shared_ptr<CachedObject>;
+
     bool mOnlyClean;
+    QList<PCachedObject> mCacheMissedObjects;
 
 protected:
+    QStringList getUnitCharsetArguments(const std::shared_ptr<ProjectUnit>& unit);
+    QString getUnitObjectFile(const std::shared_ptr<ProjectUnit>& unit);
+    void restoreObjectsFromCache();
+    QString findFastLinker();
+    bool useSplitDebugInfo();
+    QStringList getCCompileArguments(bool checkSyntax) override;
+    QStringList getCppCompileArguments(bool checkSyntax) override;
+    QStringList getLibraryArguments(FileType fileType) override;
     bool prepareForCompile() override;
     bool prepareForRebuild() override;
+    bool beforeRunExtraCommand(int idx) override;
+    bool fetchOutputFromCache() override;
+    void storeOutputToCache() override;
 };
 
 #endif // PROJECTCOMPILER_H
@@ -82,6 +82,12 @@ bool StdinCompiler::prepareForCompile()
         else
             return false;
     }
+    if (fileType != FileType::GAS) {
+        mArguments += getPrecompiledHeaderArguments(strFileType == "C++", mArguments, mContent);
+        QStringList diagnosticsArguments = getStructuredDiagnosticsArguments();
+        mArguments += diagnosticsArguments;
+        mStructuredDiagnostics = !diagnosticsArguments.isEmpty();
+    }
 
     log(tr("Processing %1 source file:").arg(strFileType));
     log("------------------");
@@ -15,9 +15,12 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <QFile>
+#include <QSaveFile>
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <QThreadPool>
 #include <qsynedit/document.h>
+#include <qsynedit/syntaxer/cpp.h>
 #include "cpprefacter.h"
 #include "mainwindow.h"
 #include "settings.h"
@@ -134,7 +137,6 @@ void CppRefacter::renameSymbol(Editor *editor, const QSynedit::BufferCoord &pos,
     // definition of the symbol not found
     if (!oldStatement)
         return;
-    QString oldScope = fullParentName(oldStatement);
     // found but not in this file
     if (editor->filename() != oldStatement->fileName
             || editor->filename() != oldStatement->definitionFileName) {
@@ -144,19 +146,28 @@ void CppRefacter::renameSymbol(Editor *editor, const QSynedit::BufferCoord &pos,
         return;
     }
 
-    QStringList newExpression = expression;
-    newExpression[newExpression.count()-1]=newWord;
-    PStatement newStatement = editor->parser()->findStatementOf(
-                editor->filename(),
-                newExpression,
-                pos.line);
-    if (newStatement && fullParentName(newStatement) == oldScope) {
-        QMessageBox::critical(editor,
-                              tr("Rename Symbol Error"),
-                              tr("New symbol already exists!"));
-        return;
+    QStringList files;
+    files.append(editor->filename());
+    std::shared_ptr<Project> project = pMainWindow->project();
+    if (oldStatement->scope != StatementScope::Local
+            && editor->inProject() && project) {
+        foreach (const PProjectUnit& unit, project->unitList()) {
+            if (unit->fileName() != editor->filename()
+                    && (isCFile(unit->fileName()) || isHFile(unit->fileName())))
+                files.append(unit->fileName());
+        }
+    }
+    QList<PRenameFilePlan> plans = planRename(files, oldStatement, newWord, editor->parser());
+    //check every planned file before anything is changed
+    foreach (const PRenameFilePlan& plan, plans) {
+        if (plan->newNameExists) {
+            QMessageBox::critical(editor,
+                                  tr("Rename Symbol Error"),
+                                  tr("New symbol already exists in '%1'!").arg(plan->filename));
+            return;
+        }
     }
-    renameSymbolInFile(editor->filename(),oldStatement,newWord, editor->parser());
+    applyRename(plans, newWord);
 }
 
 void CppRefacter::doFindOccurenceInEditor(PStatement statement , Editor *editor, const PCppParser &parser)
@@ -289,115 +300,159 @@ PSearchResultTreeItem CppRefacter::findOccurenceInFile(
     return parentItem;
 }
 
-void CppRefacter::renameSymbolInFile(const QString &filename, const PStatement &statement,  const QString &newWord, const PCppParser &parser)
+QList<PRenameFilePlan> CppRefacter::planRename(
+        const QStringList &files,
+        const PStatement &statement,
+        const QString &newWord,
+        const PCppParser &parser)
 {
-    QStringList buffer;
-    Editor * oldEditor=pMainWindow->editorList()->getOpenedEditorByFilename(filename);
-    if (oldEditor){
-        QSynedit::PSyntaxer syntaxer = syntaxerManager.getSyntaxer(QSynedit::ProgrammingLanguage::CPP);
-        int posY = 0;
-        oldEditor->clearSelection();
-        oldEditor->addGroupBreak();
-        oldEditor->beginEditing();
-        while (posY < oldEditor->lineCount()) {
-            QString line = oldEditor->document()->getLine(posY);
-            if (posY == 0) {
-                syntaxer->resetState();
-            } else {
-                syntaxer->setState(
-                            oldEditor->document()->getSyntaxState(posY-1));
-            }
-            syntaxer->setLine(line,posY);
-            QString newLine;
-            while (!syntaxer->eol()) {
-                int start = syntaxer->getTokenPos() + 1;
-                QString token = syntaxer->getToken();
-                if (token == statement->command) {
-                    //same name symbol , test if the same statement;
-                    QSynedit::BufferCoord p;
-                    p.line = posY+1;
-                    p.ch = start;
-
-                    QStringList expression = oldEditor->getExpressionAtPosition(p);
-                    PStatement tokenStatement = parser->findStatementOf(
-                                filename,
-                                expression, p.line);
-                    if (tokenStatement
-                            && (tokenStatement->line == statement->line)
-                            && (tokenStatement->fileName == statement->fileName)) {
-                        token = newWord;
-                    }
-                }
-                newLine += token;
-                syntaxer->next();
+    QList<PRenameFilePlan> plans;
+    std::shared_ptr<Project> project = pMainWindow->project();
+    //snapshot contents on the GUI thread, nothing is modified until all files are planned
+    foreach (const QString& filename, files) {
+        PRenameFilePlan plan = std::make_shared<RenameFilePlan>();
+        plan->filename = filename;
+        plan->editor = pMainWindow->editorList()->getOpenedEditorByFilename(filename);
+        plan->newNameExists = false;
+        if (plan->editor) {
+            plan->lines = plan->editor->contents();
+        } else {
+            if (!fileExists(filename))
+                continue;
+            QByteArray fileEncoding = ENCODING_AUTO_DETECT;
+            PProjectUnit unit = project ? project->findUnit(filename) : PProjectUnit();
+            if (unit)
+                fileEncoding = (unit->encoding()==ENCODING_PROJECT)?project->options().encoding:unit->encoding();
+            plan->document = std::make_shared<QSynedit::Document>(QFont());
+            try {
+                plan->document->loadFromFile(filename,fileEncoding,plan->encoding);
+            } catch(FileError e) {
+                QMessageBox::critical(pMainWindow,
+                            tr("Rename Symbol Error"),
+                            e.reason());
+                return QList<PRenameFilePlan>();
             }
-            if (newLine!=line)
-                oldEditor->replaceLine(posY+1,newLine);
-            posY++;
-        }
-        oldEditor->endEditing();
-    } else {
-        Editor editor(nullptr);
-        QByteArray encoding;
-        editor.setSyntaxer(syntaxerManager.getSyntaxer(QSynedit::ProgrammingLanguage::CPP));
-        try {
-            editor.document()->loadFromFile(filename,ENCODING_AUTO_DETECT,encoding);
-        } catch(FileError e) {
-            QMessageBox::critical(pMainWindow,
-                        tr("Rename Symbol Error"),
-                        e.reason());
-            return;
+            plan->lines = plan->document->contents();
         }
+        plans.append(plan);
+    }
 
-        QStringList newContents;
-        int posY = 0;
-        while (posY < editor.lineCount()) {
-            QString line = editor.document()->getLine(posY);
-            if (posY == 0) {
-                editor.syntaxer()->resetState();
-            } else {
-                editor.syntaxer()->setState(
-                            editor.document()->getSyntaxState(posY-1));
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount(), plans.count())));
+    foreach (const PRenameFilePlan& plan, plans) {
+        pool.start(QRunnable::create([plan,&statement,&newWord,&parser]{
+            plan->edits = collectRenameEdits(plan->filename, plan->lines, statement,
+                                             newWord, parser, plan->newNameExists);
+        }));
+    }
+    pool.waitForDone();
+    return plans;
+}
+
+bool CppRefacter::applyRename(const QList<PRenameFilePlan> &plans, const QString &newWord)
+{
+    bool result = true;
+    foreach (const PRenameFilePlan& plan, plans) {
+        if (plan->edits.isEmpty())
+            continue;
+        //edits are in text order, replace from right to left so positions stay valid
+        QMap<int,QString> changedLines;
+        for (int i=plan->edits.count()-1;i>=0;i--) {
+            const RenameEdit& edit = plan->edits[i];
+            if (!changedLines.contains(edit.line))
+                changedLines.insert(edit.line, plan->lines[edit.line-1]);
+            changedLines[edit.line].replace(edit.start-1, edit.len, newWord);
+        }
+        if (plan->editor) {
+            //one undoable transaction per editor
+            plan->editor->clearSelection();
+            plan->editor->addGroupBreak();
+            plan->editor->beginEditing();
+            for (auto it=changedLines.constBegin();it!=changedLines.constEnd();++it) {
+                plan->editor->replaceLine(it.key(),it.value());
             }
-            editor.syntaxer()->setLine(line,posY);
-            QString newLine;
-            while (!editor.syntaxer()->eol()) {
-                int start = editor.syntaxer()->getTokenPos() + 1;
-                QString token = editor.syntaxer()->getToken();
-                if (token == statement->command) {
-                    //same name symbol , test if the same statement;
-                    QSynedit::BufferCoord p;
-                    p.line = posY+1;
-                    p.ch = start;
+            plan->editor->endEditing();
+        } else {
+            for (auto it=changedLines.constBegin();it!=changedLines.constEnd();++it) {
+                plan->document->putLine(it.key()-1,it.value(),false);
+            }
+            QByteArray encoding = plan->encoding;
+            if (encoding == ENCODING_ASCII)
+                encoding = ENCODING_AUTO_DETECT;
+            QByteArray realEncoding;
+            //write to a temporary file and rename it over the original
+            QSaveFile file(plan->filename);
+            try {
+                plan->document->saveToFile(file,encoding,
+                                           pSettings->editor().defaultEncoding(),
+                                           realEncoding);
+                if (!file.commit())
+                    throw FileError(tr("Can't save file '%1'.").arg(plan->filename));
+            } catch(FileError e) {
+                QMessageBox::critical(pMainWindow,
+                            tr("Rename Symbol Error"),
+                            e.reason());
+                result = false;
+            }
+        }
+    }
+    return result;
+}
 
-                    QStringList expression = editor.getExpressionAtPosition(p);
-                    PStatement tokenStatement = parser->findStatementOf(
-                                filename,
-                                expression, p.line);
-                    if (tokenStatement
-                            && (tokenStatement->line == statement->line)
-                            && (tokenStatement->fileName == statement->fileName)) {
-                        token = newWord;
-                    }
-                }
-                newLine += token;
-                editor.syntaxer()->next();
+QList<RenameEdit> CppRefacter::collectRenameEdits(
+        const QString &filename,
+        const QStringList &lines,
+        const PStatement &statement,
+        const QString &newWord,
+        const PCppParser &parser,
+        bool &newNameExists)
+{
+    QList<RenameEdit> result;
+    QString oldScope = fullParentName(statement);
+    newNameExists = false;
+    QSynedit::CppSyntaxer syntaxer;
+    QVector<QSynedit::SyntaxState> states(lines.count());
+    QList<RenameEdit> candidates;
+    syntaxer.resetState();
+    for (int posY=0;posY<lines.count();posY++) {
+        if (posY>0)
+            syntaxer.setState(states[posY-1]);
+        syntaxer.setLine(lines[posY],posY);
+        while (!syntaxer.eol()) {
+            if (syntaxer.getToken() == statement->command) {
+                RenameEdit edit;
+                edit.line = posY+1;
+                edit.start = syntaxer.getTokenPos() + 1;
+                edit.len = statement->command.length();
+                candidates.append(edit);
             }
-            newContents.append(newLine);
-            posY++;
+            syntaxer.next();
         }
-        QByteArray realEncoding;
-        QFile file(filename);
-        try {
-            editor.document()->saveToFile(file,ENCODING_AUTO_DETECT,
-                                       pSettings->editor().defaultEncoding(),
-                                       realEncoding);
-        } catch(FileError e) {
-            QMessageBox::critical(pMainWindow,
-                        tr("Rename Symbol Error"),
-                        e.reason());
-            return;
+        states[posY] = syntaxer.getState();
+    }
+    foreach (const RenameEdit& edit, candidates) {
+        //same name symbol , test if the same statement;
+        QStringList expression = Editor::getExpressionAtPosition(
+                    QSynedit::BufferCoord{edit.start, edit.line},
+                    lines.count(),
+                    [&lines](int line){ return lines[line]; },
+                    [&states](int line){ return states[line]; });
+        PStatement tokenStatement = parser->findStatementOf(
+                    filename,
+                    expression, edit.line);
+        if (tokenStatement
+                && (tokenStatement->line == statement->line)
+                && (tokenStatement->fileName == statement->fileName)) {
+            result.append(edit);
+            //the new name must not resolve to another symbol in the same scope here
+            QStringList newExpression = expression;
+            newExpression[newExpression.count()-1]=newWord;
+            PStatement newStatement = parser->findStatementOf(
+                        filename,
+                        newExpression, edit.line);
+            if (newStatement && fullParentName(newStatement) == oldScope)
+                newNameExists = true;
         }
-
     }
+    return result;
 }
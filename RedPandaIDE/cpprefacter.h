@@ -25,8 +25,28 @@
 class Editor;
 namespace QSynedit {
     struct BufferCoord;
+    class Document;
 }
 class Project;
+
+struct RenameEdit {
+    int line; // 1-based
+    int start; // 1-based char position
+    int len;
+};
+
+struct RenameFilePlan {
+    QString filename;
+    Editor* editor; // nullptr if the file is not opened
+    std::shared_ptr<QSynedit::Document> document; // only for files not opened
+    QByteArray encoding;
+    QStringList lines;
+    QList<RenameEdit> edits;
+    bool newNameExists; // the new name already names a symbol in this file
+};
+
+using PRenameFilePlan = std::shared_ptr<RenameFilePlan>;
+
 class CppRefacter : public QObject
 {
     Q_OBJECT
@@ -45,11 +65,21 @@ private:
             const QByteArray& fileEncoding,
             const PStatement& statement,
             const PCppParser& parser);
-    void renameSymbolInFile(
-            const QString& filename,
+    QList<PRenameFilePlan> planRename(
+            const QStringList& files,
             const PStatement& statement,
             const QString& newWord,
             const PCppParser& parser);
+    bool applyRename(
+            const QList<PRenameFilePlan>& plans,
+            const QString& newWord);
+    static QList<RenameEdit> collectRenameEdits(
+            const QString& filename,
+            const QStringList& lines,
+            const PStatement& statement,
+            const QString& newWord,
+            const PCppParser& parser,
+            bool& newNameExists);
 };
 
 #endif // CPPREFACTER_H
@@ -1753,6 +1753,14 @@ void Editor::clearSyntaxIssues()
     mSyntaxIssues.clear();
 }
 
+int Editor::syntaxIssueCount() const
+{
+    int count = 0;
+    foreach (const PSyntaxIssueList& lst, mSyntaxIssues)
+        count += lst->count();
+    return count;
+}
+
 void Editor::gotoNextSyntaxIssue()
 {
     auto iter = mSyntaxIssues.find(caretY());
@@ -2368,24 +2376,37 @@ QStringList Editor::getOwnerExpressionAndMemberAtPositionForCompletion(
 QStringList Editor::getExpressionAtPosition(
         const QSynedit::BufferCoord &pos)
 {
-    QStringList result;
     if (!parser())
-        return result;
+        return QStringList();
+    return getExpressionAtPosition(
+                pos,
+                lineCount(),
+                [this](int line){ return document()->getLine(line); },
+                [this](int line){ return document()->getSyntaxState(line); });
+}
+
+QStringList Editor::getExpressionAtPosition(
+        const QSynedit::BufferCoord &pos,
+        int lineCount,
+        const std::function<QString (int)> &getLine,
+        const std::function<QSynedit::SyntaxState (int)> &getSyntaxState)
+{
+    QStringList result;
     int line = pos.line-1;
     int ch = pos.ch-1;
     int symbolMatchingLevel = 0;
     LastSymbolType lastSymbolType=LastSymbolType::None;
     QSynedit::CppSyntaxer syntaxer;
     while (true) {
-        if (line>=lineCount() || line<0)
+        if (line>=lineCount || line<0)
             break;
         QStringList tokens;
         if (line==0) {
             syntaxer.resetState();
         } else {
-            syntaxer.setState(document()->getSyntaxState(line-1));
+            syntaxer.setState(getSyntaxState(line-1));
         }
-        QString sLine = document()->getLine(line);
+        QString sLine = getLine(line);
         syntaxer.setLine(sLine,line-1);
         while (!syntaxer.eol()) {
             int start = syntaxer.getTokenPos();
@@ -2417,7 +2438,7 @@ QStringList Editor::getExpressionAtPosition(
                 if (token==">") {
                     lastSymbolType=LastSymbolType::MatchingAngleQuotation;
                     symbolMatchingLevel=0;
-                } else if (isIdentStartChar(token.front())) {
+                } else if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
@@ -2432,7 +2453,7 @@ QStringList Editor::getExpressionAtPosition(
                 } else if (token == "]") {
                     lastSymbolType=LastSymbolType::MatchingBracket;
                     symbolMatchingLevel = 0;
-                } else if (isIdentStartChar(token.front())) {
+                } else if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
@@ -2441,7 +2462,7 @@ QStringList Editor::getExpressionAtPosition(
                 if (token == '*') {                    
                 } else {
                     QChar ch=token.front();
-                    if (isIdentChar(ch)
+                    if (syntaxer.isIdentChar(ch)
                             || ch.isDigit()
                             || ch == '.'
                             || ch == ')' ) {
@@ -2453,7 +2474,7 @@ QStringList Editor::getExpressionAtPosition(
             case LastSymbolType::AmpersandSign: // before '&':
             {
                 QChar ch=token.front();
-                if (isIdentChar(ch)
+                if (syntaxer.isIdentChar(ch)
                         || ch.isDigit()
                         || ch == '.'
                         || ch == ')' ) {
@@ -2485,7 +2506,7 @@ QStringList Editor::getExpressionAtPosition(
                     lastSymbolType=LastSymbolType::AsteriskSign;
                 } else if (token == "&") {
                     lastSymbolType=LastSymbolType::AmpersandSign;
-                } else if (isIdentStartChar(token.front())) {
+                } else if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
@@ -2497,13 +2518,13 @@ QStringList Editor::getExpressionAtPosition(
                 } else if (token == "]") {
                     lastSymbolType=LastSymbolType::MatchingBracket;
                     symbolMatchingLevel = 0;
-                } else if (isIdentStartChar(token.front())) {
+                } else if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
                 break;
             case LastSymbolType::AngleQuotationMatched: //before '<>'
-                if (isIdentStartChar(token.front())) {
+                if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
@@ -2525,7 +2546,7 @@ QStringList Editor::getExpressionAtPosition(
                 } else if (token == "]") {
                     lastSymbolType=LastSymbolType::MatchingBracket;
                     symbolMatchingLevel = 0;
-                } else if (isIdentStartChar(token.front())) {
+                } else if (syntaxer.isIdentStartChar(token.front())) {
                     lastSymbolType=LastSymbolType::Identifier;
                 } else
                     return result;
@@ -2598,7 +2619,7 @@ QStringList Editor::getExpressionAtPosition(
 
         line--;
         if (line>=0)
-            ch = document()->getLine(line).length()+1;
+            ch = getLine(line).length()+1;
     }
     return result;
 }
@@ -3244,6 +3265,8 @@ void Editor::reparse(bool resetParser)
         }
     }
     parseFile(mParser,mFilename, inProject());
+    if (mHeaderCompletionPopup)
+        mHeaderCompletionPopup->prepareIndex(mParser);
 }
 
 void Editor::reparseTodo()
@@ -5118,7 +5141,7 @@ void Editor::reformat(bool doReparse)
     pMainWindow->logToolsOutput("------------------");
     pMainWindow->logToolsOutput(tr("- Astyle: %1").arg(astyle));
     pMainWindow->logToolsOutput(tr("- Command: %1").arg(command));
-    auto [newContent, astyleError, processError] =
+    auto [newContent, astyleError, processError, exitCode] =
         runAndGetOutput(astyle, extractFileDir(astyle), args, content, true);
     if (!astyleError.isEmpty()) {
 #ifdef Q_OS_WIN
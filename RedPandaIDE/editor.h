@@ -20,6 +20,7 @@
 #include <QObject>
 #include <utils.h>
 #include <QTabWidget>
+#include <functional>
 #include "qsynedit/qsynedit.h"
 #include "colorscheme.h"
 #include "common.h"
@@ -168,6 +169,7 @@ public:
 
     void addSyntaxIssues(int line, int startChar, int endChar, CompileIssueType errorType, const QString& hint);
     void clearSyntaxIssues();
+    int syntaxIssueCount() const;
     void gotoNextSyntaxIssue();
     void gotoPrevSyntaxIssue();
     bool hasPrevSyntaxIssue() const;
@@ -222,6 +224,12 @@ public:
     QString getWordForCompletionSearch(const QSynedit::BufferCoord& pos,bool permitTilde);
     QStringList getExpressionAtPosition(
             const QSynedit::BufferCoord& pos);
+    // Same as above, but works on a plain line snapshot so it can run off the GUI thread
+    static QStringList getExpressionAtPosition(
+            const QSynedit::BufferCoord& pos,
+            int lineCount,
+            const std::function<QString (int)>& getLine,
+            const std::function<QSynedit::SyntaxState (int)>& getSyntaxState);
     void resetBookmarks();
 
     const PCppParser &parser() const;
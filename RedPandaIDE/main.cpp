@@ -40,6 +40,7 @@
 #include "thememanager.h"
 #include "utils/font.h"
 #include "problems/ojproblemset.h"
+#include "compiler/executablerunner.h"
 
 #ifdef Q_OS_WIN
 #include <QTemporaryFile>
@@ -354,10 +355,13 @@ int main(int argc, char *argv[])
         }
     }
     qRegisterMetaType<POJProblem>("POJProblem");
+    qRegisterMetaType<ProgramRunStatistics>("ProgramRunStatistics");
     qRegisterMetaType<PCompileIssue>("PCompileIssue");
     qRegisterMetaType<PCompileIssue>("PCompileIssue&");
+    qRegisterMetaType<QList<PCompileIssue>>("QList<PCompileIssue>");
     qRegisterMetaType<QVector<int>>("QVector<int>");
     qRegisterMetaType<QHash<int,QString>>("QHash<int,QString>");
+    qRegisterMetaType<QList<PTodoItem>>("QList<PTodoItem>");
 
     initParser();
 
@@ -75,6 +75,7 @@
 #include "iconsmanager.h"
 #include "widgets/newclassdialog.h"
 #include "widgets/newheaderdialog.h"
+#include "widgets/symbolsearchdialog.h"
 #ifdef ENABLE_LUA_ADDON
 #include "addon/executor.h"
 #include "addon/runtime.h"
@@ -107,6 +108,8 @@
 #include <windows.h>
 #endif
 
+#define MAX_SYNTAX_ISSUES_PER_EDITOR 500
+
 static const char *Translation[] =
 {
   QT_TRANSLATE_NOOP("QFileSystemModel", "<b>The name \"%1\" cannot be used.</b><p>Try using another name, with fewer characters or no punctuation marks.")
@@ -289,6 +292,7 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onDebugMemoryAddressInput);
 
     mTodoParser = std::make_shared<TodoParser>();
+    mSymbolIndex = std::make_shared<SymbolIndex>();
     mSymbolUsageManager = std::make_shared<SymbolUsageManager>();
     try {
         mSymbolUsageManager->load();
@@ -366,8 +370,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(&mOJProblemSetModel, &OJProblemSetModel::problemNameChanged,
             this , &MainWindow::onProblemNameChanged);
     ui->pbProblemCases->setVisible(false);
-    connect(&mCCHandler, &CompetitiveCompanionHandler::newProblemReceived,
-            this, &MainWindow::onNewProblemReceived);
+    connect(&mCCHandler, &CompetitiveCompanionHandler::newProblemsReceived,
+            this, &MainWindow::onNewProblemsReceived);
 
     connect(&mOJProblemModel, &OJProblemModel::dataChanged,
             this, &MainWindow::updateProblemTitle);
@@ -1260,14 +1264,14 @@ void MainWindow::executeTool(PToolItem item)
             QString cmd="cmd";
             QStringList args{"/C",file.fileName()};
             command = escapeCommandForPlatformShell(cmd, args);
-            auto [o, _, em] = runAndGetOutput(cmd, workDir, args, inputContent);
+            auto [o, _, em, exitCode] = runAndGetOutput(cmd, workDir, args, inputContent);
             output = o;
             errorMessage = em;
         }
     } else {
 #endif
         command = escapeCommandForPlatformShell(program, params);
-        auto [o, _, em] = runAndGetOutput(program, workDir, params, inputContent);
+        auto [o, _, em, exitCode] = runAndGetOutput(program, workDir, params, inputContent);
         output = o;
         errorMessage = em;
 #ifdef Q_OS_WIN
@@ -1827,6 +1831,7 @@ void MainWindow::openProject(QString filename, bool openFiles)
     //  UpdateClassBrowsing;
 
     scanActiveProject(true);
+    mSymbolIndex->setParser(mProject->cppParser());
 
     mBookmarkModel->setIsForProject(true);
     mBookmarkModel->loadProjectBookmarks(
@@ -2115,6 +2120,7 @@ void MainWindow::updateActionIcons()
     pIconsManager->setIcon(ui->btnProblemCaseInputFileName, IconsManager::ACTION_MISC_FOLDER);
     pIconsManager->setIcon(ui->btnProblemCaseClearExpectedOutputFileName, IconsManager::ACTION_MISC_CLEAN);
     pIconsManager->setIcon(ui->btnProblemCaseExpectedOutputFileName, IconsManager::ACTION_MISC_FOLDER);
+    pIconsManager->setIcon(ui->btnProblemCaseOpenOutput, IconsManager::ACTION_FILE_OPEN);
 
     mProblem_Properties->setIcon(pIconsManager->getIcon(IconsManager::ACTION_PROBLEM_PROPERTIES));
 
@@ -2176,12 +2182,9 @@ void MainWindow::checkSyntaxInBack(Editor *e)
             && fileType != FileType::GAS
             )
         return;
-    if (mCompilerManager->backgroundSyntaxChecking())
-        return;
+    //a running check of the same file is cancelled by the compiler manager
     if (mCompilerManager->compiling())
         return;
-    if (mCheckSyntaxInBack)
-        return;
 
     if (mCompileIssuesState==CompileIssuesState::ProjectCompilationResultFilled
             || mCompileIssuesState==CompileIssuesState::ProjectCompiling) {
@@ -2192,7 +2195,6 @@ void MainWindow::checkSyntaxInBack(Editor *e)
     }
 
     mCheckSyntaxInBack=true;
-    clearIssues();
     CompileTarget target =getCompileTarget();
     if (target ==CompileTarget::Project) {
         int index = mProject->options().compilerSet;
@@ -2350,6 +2352,7 @@ void MainWindow::runExecutable(
         if (pSettings->executor().minimizeOnRun()) {
             showMinimized();
         }
+        mRunningExecutable = exeName;
         mCompilerManager->run(exeName,params,QFileInfo(exeName).absolutePath(),binDirs);
     } else if (runType == RunType::ProblemCases) {
         POJProblem problem = mOJProblemModel.problem();
@@ -2931,6 +2934,13 @@ void MainWindow::createCustomActions()
     connect(mProblem_batchSetCases, &QAction::triggered, this,
             &MainWindow::onProblemBatchSetCases);
 
+    mProblem_StressTest = createGlobalAction(
+                tr("Stress Test"),
+                "Problem_StressTest",
+                tr("Problem"));
+    connect(mProblem_StressTest, &QAction::triggered, this,
+            &MainWindow::onProblemStressTest);
+
     //Bookmark
     ui->tableBookmark->setContextMenuPolicy(Qt::CustomContextMenu);
     mBookmark_Remove=createAction(
@@ -4237,6 +4247,32 @@ void MainWindow::onLstProblemSetContextMenu(const QPoint &pos)
         });
         menuSetAnswer->addAction(action);
         menu.addMenu(menuSetAnswer);
+        action = new QAction(tr("Select generator source file..."),&menu);
+        connect(action, &QAction::triggered,
+                [problem,this](){
+            QString filename = QFileDialog::getOpenFileName(
+                        this,
+                        tr("Select Generator Source File"),
+                        extractFileDir(problem->generatorProgram),
+                        tr("C/C++ Source Files (*.c *.cpp *.cc *.cxx)"),
+                        nullptr);
+            if (!filename.isEmpty())
+                problem->generatorProgram = filename;
+        });
+        menu.addAction(action);
+        action = new QAction(tr("Select brute force source file..."),&menu);
+        connect(action, &QAction::triggered,
+                [problem,this](){
+            QString filename = QFileDialog::getOpenFileName(
+                        this,
+                        tr("Select Brute Force Source File"),
+                        extractFileDir(problem->bruteForceProgram),
+                        tr("C/C++ Source Files (*.c *.cpp *.cc *.cxx)"),
+                        nullptr);
+            if (!filename.isEmpty())
+                problem->bruteForceProgram = filename;
+        });
+        menu.addAction(action);
         mProblem_GotoUrl->setEnabled(!problem->url.isEmpty());
         mProblem_OpenSource->setEnabled(!problem->answerProgram.isEmpty());
     } else {
@@ -4258,9 +4294,11 @@ void MainWindow::onTableProblemCasesContextMenu(const QPoint &pos)
     QModelIndex idx = ui->tblProblemCases->currentIndex();
     menu.addAction(mProblem_RunAllCases);
     menu.addAction(mProblem_RunCurrentCase);
+    menu.addAction(mProblem_StressTest);
     menu.addAction(mProblem_CaseValidationOptions);
     mProblem_RunAllCases->setEnabled(mOJProblemModel.count()>0 && ui->actionRun->isEnabled());
     mProblem_RunCurrentCase->setEnabled(idx.isValid() && ui->actionRun->isEnabled());
+    mProblem_StressTest->setEnabled(mOJProblemModel.problem() && ui->actionRun->isEnabled());
     menu.exec(ui->tblProblemCases->mapToGlobal(pos));
 }
 
@@ -4338,6 +4376,7 @@ void MainWindow::onProblemCaseIndexChanged(const QModelIndex &current, const QMo
     ui->btnProblemCaseExpectedOutputFileName->setEnabled(false);
     ui->txtProblemCaseExpectedOutputFileName->clear();
     ui->txtProblemCaseExpectedOutputFileName->setToolTip("");
+    ui->btnProblemCaseOpenOutput->setVisible(false);
 
     mProblem_RemoveCases->setEnabled(false);
     mProblem_RunAllCases->setEnabled(false);
@@ -4411,17 +4450,23 @@ void MainWindow::onProblemBatchSetCases()
     }
 }
 
-void MainWindow::onNewProblemReceived(int num, int total, POJProblem newProblem)
+void MainWindow::onNewProblemsReceived(const QList<POJProblem> &newProblems)
 {
-    if (mOJProblemSetModel.problemNameUsed(newProblem->name))
+    QList<POJProblem> problems;
+    foreach (const POJProblem& problem, newProblems) {
+        if (!mOJProblemSetModel.problemNameUsed(problem->name))
+            problems.append(problem);
+    }
+    if (problems.isEmpty())
         return;
-    updateStatusbarMessage(tr("Problem '%1' received (%2/%3).")
-                              .arg(newProblem->name).arg(num).arg(total));
-    mOJProblemSetModel.addProblem(newProblem);
+    if (problems.count()==1)
+        updateStatusbarMessage(tr("Problem '%1' received.").arg(problems.front()->name));
+    else
+        updateStatusbarMessage(tr("%1 problems received.").arg(problems.count()));
+    int firstRow = mOJProblemSetModel.count();
+    mOJProblemSetModel.addProblems(problems);
     ui->tabExplorer->setCurrentWidget(ui->tabProblemSet);
-    ui->lstProblemSet->setCurrentIndex(mOJProblemSetModel.index(
-                                           mOJProblemSetModel.count()-1
-                                           ,0));
+    ui->lstProblemSet->setCurrentIndex(mOJProblemSetModel.index(firstRow,0));
     if (isMinimized())
         showNormal();
     raise(); // for mac OS?
@@ -4896,7 +4941,7 @@ void MainWindow::onClassBrowserChangeScope()
 
 void MainWindow::onClassBrowserRefreshStart()
 {
-    mClassBrowserCurrentStatement="";
+    mClassBrowserCurrentStatement=ClassBrowserNodeKey();
     QModelIndex index = ui->classBrowser->currentIndex();
     if (!index.isValid())
         return ;
@@ -4907,10 +4952,7 @@ void MainWindow::onClassBrowserRefreshStart()
     if (!statement) {
         return;
     }
-    mClassBrowserCurrentStatement=QString("%1+%2+%3")
-            .arg(statement->fullName)
-            .arg(statement->noNameArgs)
-            .arg((int)statement->kind);
+    mClassBrowserCurrentStatement=ClassBrowserNodeKey::fromStatement(statement);
 }
 
 void MainWindow::onClassBrowserRefreshEnd()
@@ -5280,19 +5322,14 @@ void MainWindow::stopDebugForNoSymbolTable()
     }
 }
 
-void MainWindow::onTodoParsingFile(const QString& filename)
-{
-    mTodoModel.removeTodosForFile(filename);
-}
-
 void MainWindow::onTodoParseStarted()
 {
     mTodoModel.clear();
 }
 
-void MainWindow::onTodoFound(const QString& filename, int lineNo, int ch, const QString& line)
+void MainWindow::onTodosFound(const QString& filename, const QList<PTodoItem>& items)
 {
-    mTodoModel.addItem(filename,lineNo,ch,line);
+    mTodoModel.replaceTodosForFile(filename,items);
 }
 
 void MainWindow::onTodoParseFinished()
@@ -5396,6 +5433,7 @@ void MainWindow::closeProject(bool refreshEditor)
         mVisitHistoryManager->addProject(mProject->filename());
 
         mEditorList->beginUpdate();
+        mSymbolIndex->setParser(nullptr);
         mProject.reset();
 
         if (!mQuitting && refreshEditor) {
@@ -5878,26 +5916,48 @@ void MainWindow::logToolsOutput(const QString& msg)
     ui->txtToolsOutput->ensureCursorVisible();
 }
 
-void MainWindow::onCompileIssue(PCompileIssue issue)
+void MainWindow::onCompileIssues(const QList<PCompileIssue>& issues)
 {
-    if (issue->filename.isEmpty())
-        return;
-    if (issue->filename.contains("*"))
-        return;
-    ui->tableIssues->addIssue(issue);
+    QList<PCompileIssue> tableIssues;
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->filename.isEmpty())
+            continue;
+        if (issue->filename.contains("*"))
+            continue;
+        tableIssues.append(issue);
+    }
+    ui->tableIssues->addIssues(tableIssues);
+    addSyntaxIssueMarkers(tableIssues);
+}
 
-    if (issue->type == CompileIssueType::Error || issue->type ==
-            CompileIssueType::Warning) {
-        Editor* e = mEditorList->getOpenedEditorByFilename(issue->filename);
-        if (e!=nullptr && (issue->line>0)) {
-            int line = issue->line;
-            if (line > e->lineCount())
-                return;
-            int col = std::min(issue->column,e->lineText(line).length()+1);
-            if (col < 1)
-                col = e->lineText(line).length()+1;
-            e->addSyntaxIssues(line,col,issue->endColumn,issue->type,issue->description);
-        }
+void MainWindow::addSyntaxIssueMarkers(const QList<PCompileIssue> &issues)
+{
+    QString lastFilename;
+    Editor* e = nullptr;
+    int markerCount = 0;
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->type != CompileIssueType::Error
+                && issue->type != CompileIssueType::Warning)
+            continue;
+        if (issue->line<=0)
+            continue;
+        if (issue->filename != lastFilename) {
+            lastFilename = issue->filename;
+            e = mEditorList->getOpenedEditorByFilename(issue->filename);
+            if (e)
+                markerCount = e->syntaxIssueCount();
+        }
+        //an error burst shouldn't bury the editor in markers
+        if (e==nullptr || markerCount >= MAX_SYNTAX_ISSUES_PER_EDITOR)
+            continue;
+        int line = issue->line;
+        if (line > e->lineCount())
+            continue;
+        int col = std::min(issue->column,e->lineText(line).length()+1);
+        if (col < 1)
+            col = e->lineText(line).length()+1;
+        e->addSyntaxIssues(line,col,issue->endColumn,issue->type,issue->description);
+        markerCount++;
     }
 }
 
@@ -5921,8 +5981,24 @@ void MainWindow::onProjectCompileStarted()
     mCompileIssuesState = CompileIssuesState::ProjectCompiling;
 }
 
-void MainWindow::onSyntaxCheckStarted()
+void MainWindow::onSyntaxCheckStarted(const QList<PCompileIssue>& staleIssues)
 {
+    if (mCompileIssuesState != CompileIssuesState::SyntaxChecking
+            && mCompileIssuesState != CompileIssuesState::SyntaxCheckResultFilled) {
+        //issues of a compilation are replaced as a whole
+        clearIssues();
+    } else {
+        //issues of other files' checks are kept
+        QSet<QString> issueFiles = ui->tableIssues->removeIssues(staleIssues);
+        if (!issueFiles.isEmpty()) {
+            QList<PCompileIssue> remainingIssues;
+            foreach (const PCompileIssue& issue, ui->tableIssues->issues()) {
+                if (issueFiles.contains(issue->filename))
+                    remainingIssues.append(issue);
+            }
+            addSyntaxIssueMarkers(remainingIssues);
+        }
+    }
     mCompileIssuesState = CompileIssuesState::SyntaxChecking;
 }
 
@@ -6099,7 +6175,7 @@ void MainWindow::onCompileFinished(QString filename, bool isCheckSyntax)
             }
         }
     } else {
-        mCheckSyntaxInBack=false;
+        mCheckSyntaxInBack=mCompilerManager->backgroundSyntaxChecking();
     }
     updateCompileActions();
     updateAppTitle();
@@ -6130,6 +6206,52 @@ void MainWindow::onRunPausingForFinish()
     updateCompileActions();
 }
 
+void MainWindow::onRunStatisticsReady(const ProgramRunStatistics &statistics)
+{
+    updateStatusbarMessage(tr("Program exited with return value %1 after %2 seconds (%3 ms cpu time, %4 KB peak memory).")
+                           .arg(statistics.exitCode)
+                           .arg(statistics.elapsedTime/1000000.0, 0, 'f', 3)
+                           .arg((statistics.userTime+statistics.systemTime)/1000.0, 0, 'f', 1)
+                           .arg(statistics.peakMemory));
+    if (!pSettings->executor().logRunStatistics())
+        return;
+    logToolsOutput(tr("%1 exited with return value %2 after %3 seconds: %4 ms user time, %5 ms system time, %6 KB peak memory, %7 minor and %8 major page faults, %9 voluntary and %10 involuntary context switches.")
+                   .arg(extractFileName(mRunningExecutable))
+                   .arg(statistics.exitCode)
+                   .arg(statistics.elapsedTime/1000000.0, 0, 'f', 3)
+                   .arg(statistics.userTime/1000.0, 0, 'f', 1)
+                   .arg(statistics.systemTime/1000.0, 0, 'f', 1)
+                   .arg(statistics.peakMemory)
+                   .arg(statistics.minorPageFaults)
+                   .arg(statistics.majorPageFaults)
+                   .arg(statistics.voluntaryContextSwitches)
+                   .arg(statistics.involuntaryContextSwitches));
+    //runs of a project are kept in a csv file beside it, to compare them later
+    if (!mProject || mRunningExecutable.compare(mProject->outputFilename(), PATH_SENSITIVITY)!=0)
+        return;
+    QFileInfo projectInfo(mProject->filename());
+    QFile file(includeTrailingPathDelimiter(mProject->directory())
+               + projectInfo.completeBaseName() + ".runstats.csv");
+    bool isNewFile = !file.exists();
+    if (!file.open(QFile::Append | QFile::Text))
+        return;
+    if (isNewFile)
+        file.write("time,return value,elapsed (us),user time (us),system time (us),peak memory (kb),"
+                   "minor page faults,major page faults,voluntary context switches,involuntary context switches\n");
+    file.write(QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10\n")
+               .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+               .arg(statistics.exitCode)
+               .arg(statistics.elapsedTime)
+               .arg(statistics.userTime)
+               .arg(statistics.systemTime)
+               .arg(statistics.peakMemory)
+               .arg(statistics.minorPageFaults)
+               .arg(statistics.majorPageFaults)
+               .arg(statistics.voluntaryContextSwitches)
+               .arg(statistics.involuntaryContextSwitches)
+               .toUtf8());
+}
+
 void MainWindow::onRunProblemFinished()
 {
     updateProblemTitle();
@@ -6153,6 +6275,7 @@ void MainWindow::onOJProblemCaseStarted(const QString& id,int current, int total
             ui->tblProblemCases->setCurrentIndex(mOJProblemModel.index(row,0));
         }
         ui->txtProblemCaseOutput->clearAll();
+        ui->btnProblemCaseOpenOutput->setVisible(false);
         if (ui->txtProblemCaseExpected->document()->blockCount()<=5000) {
             ui->txtProblemCaseExpected->clearFormat();
         }
@@ -6168,6 +6291,19 @@ void MainWindow::onOJProblemCaseFinished(const QString& id, int current, int tot
         problemCase->testState = validator.validate(problemCase,pSettings->executor().problemCaseValidateType())?
                     ProblemCaseTestState::Passed:
                     ProblemCaseTestState::Failed;
+        if (problemCase->runCompleted) {
+            qulonglong median = problemCase->medianRunningTime();
+            int runs = problemCase->runHistory.count();
+            problemCase->recordRun(pSettings->executor().caseRegressionMargin());
+            if (problemCase->performanceRegressed)
+                logToolsOutput(tr("Case '%1' ran in %2ms, slower than its median %3ms of the last %4 runs.")
+                               .arg(problemCase->name)
+                               .arg(problemCase->runningTime)
+                               .arg(median)
+                               .arg(runs));
+        } else {
+            problemCase->performanceRegressed = false;
+        }
         mOJProblemModel.update(row);
         updateProblemCaseOutput(problemCase);
     }
@@ -6936,6 +7072,29 @@ void MainWindow::on_actionGoto_Definition_triggered()
     }
 }
 
+void MainWindow::on_actionGoto_Symbol_in_Workspace_triggered()
+{
+    PCppParser parser;
+    if (mProject) {
+        parser = mProject->cppParser();
+    } else {
+        Editor * editor = mEditorList->getEditor();
+        if (editor)
+            parser = editor->parser();
+    }
+    if (!parser)
+        return;
+    mSymbolIndex->setParser(parser);
+    SymbolSearchDialog dialog(mSymbolIndex, this);
+    if (dialog.exec()!=QDialog::Accepted)
+        return;
+    const SymbolIndexEntry& symbol = dialog.selectedSymbol();
+    Editor* e=openFile(symbol.fileName);
+    if (e) {
+        e->setCaretPositionAndActivate(symbol.line,1);
+    }
+}
+
 
 void MainWindow::on_actionFind_references_triggered()
 {
@@ -8262,6 +8421,7 @@ void MainWindow::clearIssues()
         ui->tabMessages->setTabText(i, tr("Issues"));
     }
     ui->tableIssues->clearIssues();
+    mCompilerManager->clearSyntaxCheckIssues();
     mCompileIssuesState = CompileIssuesState::None;
 }
 
@@ -8298,13 +8458,18 @@ void MainWindow::doGenerateAssembly()
 
 void MainWindow::updateProblemCaseOutput(POJProblemCase problemCase)
 {
+    //the output panel only has the head and the tail of a large output
+    bool outputTruncated = problemCase->outputHeadLines >= 0;
+    ui->btnProblemCaseOpenOutput->setVisible(outputTruncated && fileExists(problemCase->outputFileName));
     if (problemCase->testState == ProblemCaseTestState::Failed) {
         int diffLine=-1;
         if (problemCase->firstDiffLine!=-1) {
             diffLine = problemCase->firstDiffLine;
         } else
             return;
-        if (diffLine < problemCase->outputLineCounts) {
+        if (outputTruncated && diffLine >= problemCase->outputHeadLines) {
+            ui->txtProblemCaseOutput->highlightLine(problemCase->outputHeadLines, mErrorColor);
+        } else if (diffLine < problemCase->outputLineCounts) {
             ui->txtProblemCaseOutput->highlightLine(diffLine, mErrorColor);
         } else {
             ui->txtProblemCaseOutput->moveCursor(QTextCursor::MoveOperation::End);
@@ -8799,6 +8964,85 @@ void MainWindow::onAddProblemCase()
     ui->tblProblemCases->setCurrentIndex(mOJProblemModel.index(mOJProblemModel.count()-1,0));
 }
 
+void MainWindow::onProblemStressTest()
+{
+    POJProblem problem = mOJProblemModel.problem();
+    if (!problem)
+        return;
+    if (mCompilerManager->compiling() || mCompilerManager->running())
+        return;
+    QString answerSource = problem->answerProgram;
+    if (!fileExists(answerSource)) {
+        Editor * editor = mEditorList->getEditor();
+        if (!editor) {
+            QMessageBox::critical(this,tr("Stress Test"),
+                                  tr("Please set the answer source file of the problem first."));
+            return;
+        }
+        answerSource = editor->filename();
+    }
+    if (!fileExists(problem->generatorProgram)) {
+        QString filename = QFileDialog::getOpenFileName(
+                    this,
+                    tr("Select Generator Source File"),
+                    extractFileDir(answerSource),
+                    tr("C/C++ Source Files (*.c *.cpp *.cc *.cxx)"));
+        if (filename.isEmpty())
+            return;
+        problem->generatorProgram = filename;
+    }
+    if (!fileExists(problem->bruteForceProgram)) {
+        QString filename = QFileDialog::getOpenFileName(
+                    this,
+                    tr("Select Brute Force Source File"),
+                    extractFileDir(answerSource),
+                    tr("C/C++ Source Files (*.c *.cpp *.cc *.cxx)"));
+        if (filename.isEmpty())
+            return;
+        problem->bruteForceProgram = filename;
+    }
+    //sources are compiled from the disk
+    foreach (const QString& filename, QStringList({answerSource, problem->generatorProgram, problem->bruteForceProgram})) {
+        Editor * editor = mEditorList->getOpenedEditorByFilename(filename);
+        if (editor && (editor->modified() || editor->isNew())) {
+            if (!editor->save(false,false))
+                return;
+        }
+    }
+    showHideMessagesTab(ui->tabProblem,ui->actionProblem);
+    applyCurrentProblemCaseChanges();
+    clearToolsOutput();
+    mCompilerManager->runStressTest(answerSource, problem->generatorProgram, problem->bruteForceProgram, problem);
+    updateCompileActions();
+    updateAppTitle();
+}
+
+void MainWindow::onStressTestProgressUpdated(qint64 iterations, double iterationsPerSecond)
+{
+    updateStatusbarMessage(tr("Stress test: %1 iterations, %2 iterations per second")
+                           .arg(iterations)
+                           .arg(iterationsPerSecond, 0, 'f', 1));
+}
+
+void MainWindow::onStressTestMismatchFound(qint64 iteration, const QString &input, const QString &expected, const QString &output)
+{
+    POJProblem problem = mOJProblemModel.problem();
+    if (!problem)
+        return;
+    POJProblemCase problemCase = std::make_shared<OJProblemCase>();
+    problemCase->name = tr("Stress Test %1").arg(iteration);
+    problemCase->input = input;
+    problemCase->expected = expected;
+    problemCase->output = output;
+    ProblemCaseValidator validator;
+    validator.validate(problemCase, pSettings->executor().problemCaseValidateType());
+    problemCase->testState = ProblemCaseTestState::Failed;
+    mOJProblemModel.addCase(problemCase);
+    ui->tblProblemCases->setCurrentIndex(mOJProblemModel.index(mOJProblemModel.count()-1,0));
+    logToolsOutput(tr("Mismatch found in iteration %1, its input is saved as case '%2'.")
+                   .arg(iteration).arg(problemCase->name));
+}
+
 void MainWindow::onProblemRunAllCases()
 {    
     if (mOJProblemModel.count()<=0)
@@ -9685,6 +9929,15 @@ void MainWindow::on_btnProblemCaseExpectedOutputFileName_clicked()
 }
 
 
+void MainWindow::on_btnProblemCaseOpenOutput_clicked()
+{
+    QModelIndex idx = ui->tblProblemCases->currentIndex();
+    POJProblemCase problemCase = mOJProblemModel.getCase(idx.row());
+    if (!problemCase)
+        return;
+    openFile(problemCase->outputFileName);
+}
+
 void MainWindow::on_txtProblemCaseOutput_cursorPositionChanged()
 {
     QTextCursor cursor = ui->txtProblemCaseOutput->textCursor();
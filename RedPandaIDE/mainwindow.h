@@ -33,6 +33,7 @@
 #include "symbolusagemanager.h"
 #include "codesnippetsmanager.h"
 #include "todoparser.h"
+#include "parser/symbolindex.h"
 #include "toolsmanager.h"
 #include "widgets/labelwithmenu.h"
 #include "widgets/bookmarkmodel.h"
@@ -40,6 +41,7 @@
 #include "widgets/customfilesystemmodel.h"
 #include "customfileiconprovider.h"
 #include "problems/competitivecompenionhandler.h"
+#include "compiler/executablerunner.h"
 
 
 QT_BEGIN_NAMESPACE
@@ -237,22 +239,25 @@ public:
 
 public slots:
     void logToolsOutput(const QString& msg);
-    void onCompileIssue(PCompileIssue issue);
+    void onCompileIssues(const QList<PCompileIssue>& issues);
     void clearToolsOutput();
     void clearTodos();
     void onCompileStarted();
     void onProjectCompileStarted();
-    void onSyntaxCheckStarted();
+    void onSyntaxCheckStarted(const QList<PCompileIssue>& staleIssues);
     void onCompileFinished(QString filename, bool isCheckSyntax);
     void onCompileErrorOccured(const QString& reason);
     void onRunErrorOccured(const QString& reason);
     void onRunFinished();
     void onRunPausingForFinish();
+    void onRunStatisticsReady(const ProgramRunStatistics& statistics);
     void onRunProblemFinished();
     void onOJProblemCaseStarted(const QString& id, int current, int total);
     void onOJProblemCaseFinished(const QString& id, int current, int total);
     void onOJProblemCaseNewOutputGetted(const QString& id, const QString& line);
     void onOJProblemCaseResetOutput(const QString& id, const QString& line);
+    void onStressTestProgressUpdated(qint64 iterations, double iterationsPerSecond);
+    void onStressTestMismatchFound(qint64 iteration, const QString& input, const QString& expected, const QString& output);
     void cleanUpCPUDialog();
     void onDebugCommandInput(const QString& command);
     void onDebugEvaluateInput();
@@ -269,9 +274,8 @@ public slots:
     void disableDebugActions();
     void enableDebugActions();
     void stopDebugForNoSymbolTable();
-    void onTodoParsingFile(const QString& filename);
     void onTodoParseStarted();
-    void onTodoFound(const QString& filename, int lineNo, int ch, const QString& line);
+    void onTodosFound(const QString& filename, const QList<PTodoItem>& items);
     void onTodoParseFinished();
     void onWatchpointHitted(const QString& var, const QString& oldVal, const QString& newVal);
     void setActiveBreakpoint(QString FileName, int Line, bool setFocus);
@@ -280,6 +284,7 @@ public slots:
 
 private:
     void executeTool(PToolItem item);
+    void addSyntaxIssueMarkers(const QList<PCompileIssue>& issues);
     int calIconSize(const QString &fontName, int fontPointSize);
     void hideAllSearchDialogs();
     void prepareSearchDialog();
@@ -374,7 +379,8 @@ private slots:
     void onProblemNameChanged(int index);
     void onProblemRunCurrentCase();
     void onProblemBatchSetCases();
-    void onNewProblemReceived(int num, int total, POJProblem newProblem);
+    void onProblemStressTest();
+    void onNewProblemsReceived(const QList<POJProblem>& newProblems);
     void updateProblemTitle();
     void onEditorClosed();
     void onToolsOutputClear();
@@ -565,6 +571,8 @@ private slots:
 
     void on_actionGoto_Definition_triggered();
 
+    void on_actionGoto_Symbol_in_Workspace_triggered();
+
     void on_actionFind_references_triggered();
 
     void on_actionOpen_Containing_Folder_triggered();
@@ -749,6 +757,8 @@ private slots:
 
     void on_btnProblemCaseExpectedOutputFileName_clicked();
 
+    void on_btnProblemCaseOpenOutput_clicked();
+
     void on_txtProblemCaseOutput_cursorPositionChanged();
 
     void on_txtProblemCaseExpected_cursorPositionChanged();
@@ -915,6 +925,7 @@ private:
     PSymbolUsageManager mSymbolUsageManager;
     PCodeSnippetManager mCodeSnippetManager;
     PTodoParser mTodoParser;
+    PSymbolIndex mSymbolIndex;
     PToolsManager mToolsManager;
     CustomFileSystemModel mFileSystemModel;
     CustomFileIconProvider mFileSystemModelIconProvider;
@@ -922,13 +933,14 @@ private:
     OJProblemModel mOJProblemModel;
     int mOJProblemSetNameCounter;
 
-    QString mClassBrowserCurrentStatement;
+    ClassBrowserNodeKey mClassBrowserCurrentStatement;
     QString mFilesViewNewCreatedFolder;
     QString mFilesViewNewCreatedFile;
 
     bool mCheckSyntaxInBack;
     bool mShouldRemoveAllSettings;
     PCompileSuccessionTask mCompileSuccessionTask;
+    QString mRunningExecutable;
 
     QMap<QWidget*, PTabWidgetInfo> mTabInfosData;
     QMap<QWidget*, PTabWidgetInfo> mTabMessagesData;
@@ -1026,6 +1038,7 @@ private:
     QAction * mProblem_RunCurrentCase;
     QAction * mProblem_RunAllCases;
     QAction * mProblem_batchSetCases;
+    QAction * mProblem_StressTest;
 
     //action for tools output
     QAction * mToolsOutput_Clear;
@@ -1196,6 +1196,12 @@ bool CppParser::fileScanned(const QString &fileName) const
     return mPreprocessor.fileScanned(fileName);
 }
 
+QSet<QString> CppParser::scannedFiles() const
+{
+    QMutexLocker locker(&mMutex);
+    return mPreprocessor.scannedFiles();
+}
+
 bool CppParser::isFileParsed(const QString &filename) const
 {
     return mPreprocessor.fileScanned(filename);
@@ -128,6 +128,7 @@ public:
     void resetParser();
     void unFreeze(); // UnFree/UnLock (reparse while searching)
     bool fileScanned(const QString& fileName) const;
+    QSet<QString> scannedFiles() const;
 
     bool isFileParsed(const QString& filename) const;
 
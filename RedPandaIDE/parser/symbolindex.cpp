@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2020-2024 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "symbolindex.h"
+
+#include <algorithm>
+
+static bool entryLessThan(const SymbolIndexEntry& entry1, const SymbolIndexEntry& entry2)
+{
+    int comp = QString::compare(entry1.lowerName, entry2.lowerName);
+    if (comp!=0)
+        return comp<0;
+    comp = QString::compare(entry1.fileName, entry2.fileName);
+    if (comp!=0)
+        return comp<0;
+    return entry1.line < entry2.line;
+}
+
+SymbolIndex::SymbolIndex(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+PCppParser SymbolIndex::parser() const
+{
+    return mParser.lock();
+}
+
+void SymbolIndex::setParser(const PCppParser &newParser)
+{
+    PCppParser oldParser = mParser.lock();
+    if (oldParser == newParser && !mParser.expired())
+        return;
+    if (oldParser) {
+        disconnect(oldParser.get(),
+                   &CppParser::onEndParsing,
+                   this,
+                   &SymbolIndex::update);
+    }
+    mParser = newParser;
+    mEntries.clear();
+    mFileInfos.clear();
+    if (newParser) {
+        connect(newParser.get(),
+                &CppParser::onEndParsing,
+                this,
+                &SymbolIndex::update);
+        update();
+    }
+}
+
+void SymbolIndex::update()
+{
+    PCppParser parser = mParser.lock();
+    if (!parser)
+        return;
+    if (!parser->freeze())
+        return;
+    QSet<QString> scannedFiles = parser->scannedFiles();
+    QSet<QString> changedFiles;
+    QVector<SymbolIndexEntry> newEntries;
+    for (auto it=mFileInfos.begin();it!=mFileInfos.end();) {
+        if (!scannedFiles.contains(it.key())) {
+            changedFiles.insert(it.key());
+            it = mFileInfos.erase(it);
+        } else
+            ++it;
+    }
+    foreach (const QString& fileName, scannedFiles) {
+        PParsedFileInfo fileInfo = parser->findFileInfo(fileName);
+        PParsedFileInfo oldFileInfo = mFileInfos.value(fileName).lock();
+        if (fileInfo == oldFileInfo)
+            continue;
+        changedFiles.insert(fileName);
+        if (fileInfo) {
+            mFileInfos.insert(fileName, fileInfo);
+            indexFile(fileInfo, newEntries);
+        } else {
+            mFileInfos.remove(fileName);
+        }
+    }
+    parser->unFreeze();
+    if (changedFiles.isEmpty())
+        return;
+
+    //drop entries of the changed files, and merge in the new ones
+    std::sort(newEntries.begin(), newEntries.end(), entryLessThan);
+    QVector<SymbolIndexEntry> keptEntries;
+    keptEntries.reserve(mEntries.count());
+    foreach (const SymbolIndexEntry& entry, mEntries) {
+        if (!changedFiles.contains(entry.fileName))
+            keptEntries.append(entry);
+    }
+    mEntries.clear();
+    mEntries.reserve(keptEntries.count()+newEntries.count());
+    std::merge(keptEntries.begin(), keptEntries.end(),
+               newEntries.begin(), newEntries.end(),
+               std::back_inserter(mEntries), entryLessThan);
+}
+
+QList<SymbolSearchResult> SymbolIndex::search(const QString &phrase, int maxResults) const
+{
+    QList<SymbolSearchResult> results;
+    QString lowerPhrase = phrase.trimmed().toLower();
+    if (lowerPhrase.isEmpty() || maxResults<=0)
+        return results;
+    //names starting with the phrase are a range of the sorted entries, they come first
+    SymbolIndexEntry key;
+    key.lowerName = lowerPhrase;
+    auto it = std::lower_bound(mEntries.begin(), mEntries.end(), key,
+                               [](const SymbolIndexEntry& entry1, const SymbolIndexEntry& entry2) {
+        return entry1.lowerName < entry2.lowerName;
+    });
+    int prefixStart = it - mEntries.begin();
+    int prefixEnd = prefixStart;
+    while (prefixEnd<mEntries.count() && mEntries[prefixEnd].lowerName.startsWith(lowerPhrase))
+        prefixEnd++;
+    collectMatches(prefixStart, prefixEnd, lowerPhrase, maxResults, results);
+    //then the fuzzy matches in the rest
+    if (results.count()<maxResults) {
+        QList<SymbolSearchResult> fuzzyResults;
+        collectMatches(0, prefixStart, lowerPhrase, maxResults-results.count(), fuzzyResults);
+        collectMatches(prefixEnd, mEntries.count(), lowerPhrase, maxResults-results.count(), fuzzyResults);
+        std::stable_sort(fuzzyResults.begin(), fuzzyResults.end(),
+                         [](const SymbolSearchResult& r1, const SymbolSearchResult& r2) {
+            return r1.score > r2.score;
+        });
+        results.append(fuzzyResults.mid(0, maxResults-results.count()));
+    }
+    return results;
+}
+
+void SymbolIndex::collectMatches(int start, int end, const QString &lowerPhrase, int maxResults,
+                                 QList<SymbolSearchResult> &results) const
+{
+    QVector<QPair<int,int>> matches; // (score, index)
+    for (int i=start;i<end;i++) {
+        int score = fuzzyScore(mEntries[i], lowerPhrase);
+        if (score>=0)
+            matches.append(QPair<int,int>(score,i));
+    }
+    int n = std::min(maxResults, matches.count());
+    std::partial_sort(matches.begin(), matches.begin()+n, matches.end(),
+                      [](const QPair<int,int>& m1, const QPair<int,int>& m2) {
+        if (m1.first != m2.first)
+            return m1.first > m2.first;
+        return m1.second < m2.second;
+    });
+    for (int i=0;i<n;i++) {
+        SymbolSearchResult result;
+        result.score = matches[i].first;
+        result.entry = mEntries[matches[i].second];
+        results.append(result);
+    }
+}
+
+int SymbolIndex::count() const
+{
+    return mEntries.count();
+}
+
+void SymbolIndex::indexFile(const PParsedFileInfo &fileInfo, QVector<SymbolIndexEntry> &entries)
+{
+    foreach (const PStatement& statement, fileInfo->statements()) {
+        // definitions are also recorded in the declaring file
+        if (statement->fileName != fileInfo->fileName())
+            continue;
+        switch(statement->kind) {
+        case StatementKind::Block:
+        case StatementKind::Lambda:
+        case StatementKind::Parameter:
+        case StatementKind::LocalVariable:
+            continue;
+        default:
+            break;
+        }
+        if (statement->scope == StatementScope::Local)
+            continue;
+        if (statement->command.isEmpty())
+            continue;
+        SymbolIndexEntry entry;
+        entry.name = statement->command;
+        entry.lowerName = statement->command.toLower();
+        entry.fullName = statement->fullName;
+        entry.kind = statement->kind;
+        entry.fileName = statement->fileName;
+        entry.line = statement->line;
+        entries.append(entry);
+    }
+}
+
+int SymbolIndex::fuzzyScore(const SymbolIndexEntry &entry, const QString &lowerPhrase)
+{
+    const QString& lowerName = entry.lowerName;
+    if (lowerName.length() < lowerPhrase.length())
+        return -1;
+    //phrase chars must appear in order; reward word starts and consecutive runs
+    int score = 0;
+    int j = 0;
+    int last = -2;
+    for (int i=0;i<lowerName.length() && j<lowerPhrase.length();i++) {
+        if (lowerName[i] != lowerPhrase[j])
+            continue;
+        int bonus = 1;
+        if (i==0) {
+            bonus += 8;
+        } else {
+            QChar prev = entry.name[i-1];
+            QChar ch = entry.name[i];
+            if (prev == '_' || (ch.isUpper() && !prev.isUpper()))
+                bonus += 6;
+        }
+        if (last == i-1)
+            bonus += 4;
+        score += bonus;
+        last = i;
+        j++;
+    }
+    if (j < lowerPhrase.length())
+        return -1;
+    if (lowerName == lowerPhrase)
+        score += 20;
+    return score*16 - (lowerName.length() - lowerPhrase.length());
+}
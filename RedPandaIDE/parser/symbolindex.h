@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020-2024 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QObject>
+#include <QVector>
+#include "cppparser.h"
+
+struct SymbolIndexEntry {
+    QString name;
+    QString lowerName;
+    QString fullName;
+    StatementKind kind;
+    QString fileName;
+    int line;
+};
+
+struct SymbolSearchResult {
+    int score;
+    SymbolIndexEntry entry;
+};
+
+/**
+ * @brief Sorted index of all statements known by a parser, used by "Goto Symbol in Workspace".
+ * Files are reindexed when the parser finishes a parse and their parsed file info has changed.
+ * The parser isn't kept alive by the index, it may belong to an editor that is closed.
+ */
+class SymbolIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SymbolIndex(QObject *parent = nullptr);
+    PCppParser parser() const;
+    void setParser(const PCppParser &newParser);
+    QList<SymbolSearchResult> search(const QString& phrase, int maxResults) const;
+    int count() const;
+public slots:
+    void update();
+private:
+    void indexFile(const PParsedFileInfo& fileInfo, QVector<SymbolIndexEntry>& entries);
+    void collectMatches(int start, int end, const QString& lowerPhrase, int maxResults,
+                        QList<SymbolSearchResult>& results) const;
+    static int fuzzyScore(const SymbolIndexEntry& entry, const QString& lowerPhrase);
+private:
+    std::weak_ptr<CppParser> mParser;
+    QVector<SymbolIndexEntry> mEntries; // sorted by lowerName
+    QHash<QString, std::weak_ptr<ParsedFileInfo>> mFileInfos;
+};
+
+using PSymbolIndex = std::shared_ptr<SymbolIndex>;
+
+#endif // SYMBOLINDEX_H
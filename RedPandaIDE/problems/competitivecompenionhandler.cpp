@@ -16,20 +16,35 @@
  */
 #include "competitivecompenionhandler.h"
 
+#include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTextDocument>
+#include <QTimer>
 #include "ojproblemset.h"
 #include "../settings.h"
-#include "../mainwindow.h"
+
+//requests with larger headers or bodies are rejected
+#define COMPETITIVE_COMPANION_MAX_HEADER_SIZE (64*1024)
+#define COMPETITIVE_COMPANION_MAX_BODY_SIZE (256*1024*1024)
+//a connection that doesn't finish its request in time (ms) is closed
+#define COMPETITIVE_COMPANION_CONNECTION_TIMEOUT 30000
+//problems of an incomplete batch are reported after this time (ms)
+#define COMPETITIVE_COMPANION_BATCH_TIMEOUT 3000
 
 CompetitiveCompanionHandler::CompetitiveCompanionHandler(QObject *parent):
     QObject(parent),
-    mThread(nullptr)
+    mServer(nullptr),
+    mBatchSize(0)
 {
+    mBatchTimer = new QTimer(this);
+    mBatchTimer->setSingleShot(true);
+    mBatchTimer->setInterval(COMPETITIVE_COMPANION_BATCH_TIMEOUT);
+    connect(mBatchTimer, &QTimer::timeout,
+            this, &CompetitiveCompanionHandler::flushBatch);
 }
 
 void CompetitiveCompanionHandler::start()
@@ -38,76 +53,145 @@ void CompetitiveCompanionHandler::start()
         return;
     if (!pSettings->executor().enableCompetitiveCompanion())
         return;
-    mThread = new CompetitiveCompanionThread(this);
-    connect(mThread,
-                &CompetitiveCompanionThread::newProblemReceived,
-                this, &CompetitiveCompanionHandler::onNewProblemReceived);
-    mThread->start();
-    if (!mThread->waitStart()) {
+    mServer = new QTcpServer(this);
+    connect(mServer, &QTcpServer::newConnection,
+            this, &CompetitiveCompanionHandler::onNewConnection);
+    if (!mServer->listen(QHostAddress::LocalHost,pSettings->executor().competivieCompanionPort())) {
         qDebug()<<"Failed to listen!";
-        delete mThread;
-        mThread = nullptr;
+        delete mServer;
+        mServer = nullptr;
     }
 }
 
 void CompetitiveCompanionHandler::stop()
 {
-    if (!mThread)
+    if (!mServer)
         return;
-    connect(mThread, &QThread::finished,
-            mThread, &QObject::deleteLater);
-    mThread->waitStop();
-    mThread=nullptr;
+    mServer->close();
+    //the sockets are removed from mRequests when they are disconnected
+    foreach (QTcpSocket* socket, mRequests.keys())
+        socket->abort();
+    mRequests.clear();
+    flushBatch();
+    mServer->deleteLater();
+    mServer = nullptr;
 }
 
-void CompetitiveCompanionHandler::onNewProblemReceived(int num, int total, POJProblem newProblem)
+void CompetitiveCompanionHandler::onNewConnection()
 {
-    emit newProblemReceived(num, total, newProblem);
+    while (mServer && mServer->hasPendingConnections()) {
+        QTcpSocket* socket = mServer->nextPendingConnection();
+        PHttpRequest request = std::make_shared<HttpRequest>();
+        request->headerLength = -1;
+        request->contentLength = -1;
+        request->isPost = false;
+        mRequests.insert(socket, request);
+        connect(socket, &QTcpSocket::readyRead,
+                this, [this, socket]() {
+            onReadyRead(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected,
+                this, [this, socket]() {
+            PHttpRequest request = mRequests.take(socket);
+            //without Content-Length, the body ends when the client closes the connection
+            if (request && request->isPost && request->contentLength<0) {
+                request->data += socket->readAll();
+                processProblem(request->data.mid(request->headerLength));
+            }
+            socket->deleteLater();
+        });
+        QTimer::singleShot(COMPETITIVE_COMPANION_CONNECTION_TIMEOUT, socket, [socket]() {
+            socket->abort();
+        });
+        //data may have arrived before the signals are connected
+        if (socket->bytesAvailable()>0)
+            onReadyRead(socket);
+    }
 }
 
-void CompetitiveCompanionThread::onNewProblemConnection(QTcpSocket* clientConnection)
+void CompetitiveCompanionHandler::onReadyRead(QTcpSocket *socket)
 {
-    QByteArray content;
-    int unreadCount = 0;
-    while (clientConnection->state() == QTcpSocket::ConnectedState) {
-        clientConnection->waitForReadyRead(100);
-        QByteArray readed = clientConnection->readAll();
-        if (readed.isEmpty()) {
-            unreadCount ++;
-            if (!content.isEmpty() || unreadCount>30)
-                break;
-        } else {
-            unreadCount = 0;
+    PHttpRequest request = mRequests.value(socket);
+    if (!request)
+        return;
+    request->data += socket->readAll();
+    if (request->headerLength<0) {
+        if (!parseHeader(request)) {
+            finishRequest(socket, "400 Bad Request");
+            return;
+        }
+        if (request->headerLength<0)
+            return;
+        if (!request->isPost) {
+            finishRequest(socket, "405 Method Not Allowed");
+            return;
         }
-        content += readed;
     }
-    content += clientConnection->readAll();
-    clientConnection->write("HTTP/1.1 200 OK");
-    clientConnection->disconnectFromHost();
-//    qDebug()<<"---------";
-//    qDebug()<<content;
-    content = getHTTPBody(content);
-//    qDebug()<<"*********";
-//    qDebug()<<content;
-    if (content.isEmpty()) {
+    qint64 bodyLength = request->data.length() - request->headerLength;
+    if (bodyLength > COMPETITIVE_COMPANION_MAX_BODY_SIZE
+            || request->contentLength > COMPETITIVE_COMPANION_MAX_BODY_SIZE) {
+        finishRequest(socket, "413 Payload Too Large");
+        return;
+    }
+    if (request->contentLength<0 || bodyLength<request->contentLength)
+        return;
+    QByteArray body = request->data.mid(request->headerLength, request->contentLength);
+    finishRequest(socket, "200 OK");
+    processProblem(body);
+}
+
+bool CompetitiveCompanionHandler::parseHeader(const PHttpRequest &request)
+{
+    int i = request->data.indexOf("\r\n\r\n");
+    if (i<0)
+        return request->data.length() <= COMPETITIVE_COMPANION_MAX_HEADER_SIZE;
+    request->headerLength = i+4;
+    QList<QByteArray> lines = request->data.left(i).split('\n');
+    QList<QByteArray> requestLine = lines[0].trimmed().split(' ');
+    if (requestLine.count()<3)
+        return false;
+    request->isPost = (requestLine[0] == "POST");
+    for (int j=1;j<lines.count();j++) {
+        const QByteArray& line = lines[j];
+        int colon = line.indexOf(':');
+        if (colon<0)
+            continue;
+        if (line.left(colon).trimmed().toLower() == "content-length") {
+            bool ok;
+            request->contentLength = line.mid(colon+1).trimmed().toLongLong(&ok);
+            if (!ok || request->contentLength<0)
+                return false;
+        }
+    }
+    return true;
+}
+
+void CompetitiveCompanionHandler::finishRequest(QTcpSocket *socket, const QByteArray &status)
+{
+    mRequests.remove(socket);
+    socket->write("HTTP/1.1 " + status + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    socket->disconnectFromHost();
+}
+
+void CompetitiveCompanionHandler::processProblem(const QByteArray &body)
+{
+    if (body.isEmpty()) {
         return;
     }
     QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(content,&error);
+    QJsonDocument doc = QJsonDocument::fromJson(body,&error);
     if (error.error!=QJsonParseError::NoError) {
         qDebug()<<"Read http content failed!";
         qDebug()<<error.errorString();
         return;
     }
     QJsonObject obj=doc.object();
-    //qDebug()<<obj;
     QJsonObject batchObj = obj["batch"].toObject();
     QString batchId = batchObj["id"].toString();
     if (mBatchId!=batchId) {
+        flushBatch();
         mBatchId = batchId;
-        mBatchCount = batchObj["size"].toInt();
-        mBatchProblemsRecieved = 0;
-        //emit newBatchReceived(mBatchCount);
+        mBatchSize = batchObj["size"].toInt();
     }
 
     QString name = obj["name"].toString();
@@ -143,56 +227,19 @@ void CompetitiveCompanionThread::onNewProblemConnection(QTcpSocket* clientConnec
             problemCase->expected = caseObj["output"].toString();
         problem->cases.append(problemCase);
     }
-    mBatchProblemsRecieved++;
-    emit newProblemReceived(mBatchProblemsRecieved, mBatchCount, problem);
-    // if (mBatchProblemsRecieved == mBatchCount) {
-    //     emit batchFinished(mBatchCount);
-    // }
+    mBatchProblems.append(problem);
+    if (mBatchProblems.count() >= mBatchSize)
+        flushBatch();
+    else
+        mBatchTimer->start();
 }
 
-CompetitiveCompanionThread::CompetitiveCompanionThread(QObject *parent):
-    QThread{parent},
-    mStop{false},
-    mBatchProblemsRecieved{0},
-    mStartSemaphore{0},
-    mStopSemaphore{0},
-    mStartOk{false}
+void CompetitiveCompanionHandler::flushBatch()
 {
-}
-
-void CompetitiveCompanionThread::stop()
-{
-    mStop = true;
-}
-
-bool CompetitiveCompanionThread::waitStart()
-{
-    mStartSemaphore.acquire(1);
-    return mStartOk;
-}
-
-void CompetitiveCompanionThread::waitStop()
-{
-    stop();
-    mStopSemaphore.acquire(1);
-}
-
-void CompetitiveCompanionThread::run()
-{
-    QTcpServer tcpServer;
-    mStartOk = tcpServer.listen(QHostAddress::LocalHost,pSettings->executor().competivieCompanionPort());
-    if (!mStartOk) {
-        mStop=true;
-    }
-    mStartSemaphore.release(1);
-    while(!mStop) {
-        tcpServer.waitForNewConnection(1000);
-        while (tcpServer.hasPendingConnections()) {
-            QTcpSocket* clientConnection = tcpServer.nextPendingConnection();
-            onNewProblemConnection(clientConnection);
-            delete clientConnection;
-        }
-    }
-    tcpServer.close();
-    mStopSemaphore.release(1);
+    mBatchTimer->stop();
+    if (mBatchProblems.isEmpty())
+        return;
+    QList<POJProblem> problems = mBatchProblems;
+    mBatchProblems.clear();
+    emit newProblemsReceived(problems);
 }
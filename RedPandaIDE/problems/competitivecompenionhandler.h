@@ -17,43 +17,23 @@
 #ifndef COMPETITIVECOMPANIONHANDLER_H
 #define COMPETITIVECOMPANIONHANDLER_H
 #include <QObject>
+#include <QHash>
+#include <QList>
 #include <memory>
-#include <QThread>
-#include <QSemaphore>
 
 struct OJProblem;
 using POJProblem = std::shared_ptr<OJProblem>;
 
+class QTcpServer;
 class QTcpSocket;
-class CompetitiveCompanionThread: public QThread {
-    Q_OBJECT
-public:
-    explicit CompetitiveCompanionThread(QObject *parent=nullptr);
-    CompetitiveCompanionThread(const CompetitiveCompanionThread&) = delete;
-    CompetitiveCompanionThread &operator=(const CompetitiveCompanionThread&) = delete;
-    void stop();
-    bool waitStart();
-    void waitStop();
-signals:
-    void newProblemReceived(int num, int total, POJProblem newProblem);
-    // void newBatchReceived(int total);
-    // void batchFinished(int total);
-private slots:
-    void onNewProblemConnection(QTcpSocket* connection);
-    // QThread interface
-protected:
-    void run() override;
-private:
-    bool mStop;
-    QString mBatchId;
-    int mBatchCount;
-    int mBatchProblemsRecieved;
-    QSemaphore mStartSemaphore;
-    QSemaphore mStopSemaphore;
-    bool mStartOk;
-};
-
+class QTimer;
 
+/*
+ * Receives problems from the Competitive Companion browser extension.
+ * Connections are handled in the event loop: request data is buffered as it arrives,
+ * and framed by the http header and Content-Length.
+ * Problems of the same batch (a contest) are reported together when the batch is complete.
+ */
 class CompetitiveCompanionHandler: public QObject {
     Q_OBJECT
 public:
@@ -63,11 +43,30 @@ public:
     void start();
     void stop();
 signals:
-    void newProblemReceived(int num, int total, POJProblem newProblem);
+    void newProblemsReceived(const QList<POJProblem>& problems);
 private slots:
-    void onNewProblemReceived(int num, int total, POJProblem newProblem);
+    void onNewConnection();
+    void flushBatch();
 private:
-    CompetitiveCompanionThread *mThread;
+    struct HttpRequest {
+        QByteArray data;
+        int headerLength; // -1 before the header is complete
+        qint64 contentLength; // -1 if the header has no Content-Length
+        bool isPost;
+    };
+    using PHttpRequest = std::shared_ptr<HttpRequest>;
+
+    void onReadyRead(QTcpSocket* socket);
+    bool parseHeader(const PHttpRequest& request);
+    void finishRequest(QTcpSocket* socket, const QByteArray& status);
+    void processProblem(const QByteArray& body);
+private:
+    QTcpServer *mServer;
+    QHash<QTcpSocket*, PHttpRequest> mRequests;
+    QString mBatchId;
+    int mBatchSize;
+    QList<POJProblem> mBatchProblems;
+    QTimer *mBatchTimer;
 };
 
 
@@ -33,6 +33,19 @@ QList<POJProblem> importFreeProblemSet(const QString &filename)
                     }
                 }
                 currentCase->name = QObject::tr("Problem Case %1").arg(currentProblem->cases.count()+1);
+            } else if (currentProblem && !currentProblem->cases.isEmpty() &&
+                       xml.name()=="run") {
+                //run history of the last read case
+                OJProblemCaseRun run{0,0,0};
+                foreach (const QXmlStreamAttribute& attr, xml.attributes()) {
+                    if (attr.name() == "time")
+                        run.runningTime = attr.value().toULongLong();
+                    else if (attr.name() == "memory")
+                        run.runningMemory = attr.value().toULongLong();
+                    else if (attr.name() == "timestamp")
+                        run.timestamp = attr.value().toLongLong();
+                }
+                currentProblem->cases.last()->runHistory.append(run);
             } else if (currentProblem &&
                        xml.name()=="time_limit") {
                 currentEleName = xml.name().toString();
@@ -173,6 +186,17 @@ void exportFreeProblemSet(const QList<POJProblem> &problems, const QString &file
                 writer.writeStartElement("test_output");
                 writer.writeCDATA(pCase->expected);
                 writer.writeEndElement(); //test_output
+                //running time and memory of recent runs, ignored by other fps readers
+                if (!pCase->runHistory.isEmpty()) {
+                    writer.writeStartElement("run_history");
+                    foreach(const OJProblemCaseRun& run, pCase->runHistory) {
+                        writer.writeEmptyElement("run");
+                        writer.writeAttribute("time",QString::number(run.runningTime));
+                        writer.writeAttribute("memory",QString::number(run.runningMemory));
+                        writer.writeAttribute("timestamp",QString::number(run.timestamp));
+                    }
+                    writer.writeEndElement(); //run_history
+                }
             }
             {
                 writer.writeStartElement("hint");
@@ -16,23 +16,106 @@
  */
 #include "ojproblemset.h"
 
+#include <QDateTime>
+#include <QFile>
 #include <QUuid>
+#include <algorithm>
+
+//runs kept in the history of a case
+#define PROBLEM_CASE_RUN_HISTORY_SIZE 20
+//runs needed before a case can be flagged as regressed
+#define PROBLEM_CASE_REGRESSION_MIN_RUNS 3
+//differences in running time (ms) below this are noise
+#define PROBLEM_CASE_REGRESSION_MIN_DIFF 10
+
+static qulonglong medianOf(QVector<qulonglong> values)
+{
+    if (values.isEmpty())
+        return 0;
+    std::sort(values.begin(),values.end());
+    int mid = values.count()/2;
+    if (values.count() % 2 == 0)
+        return (values[mid-1]+values[mid])/2;
+    return values[mid];
+}
 
 OJProblemCase::OJProblemCase():
     testState(ProblemCaseTestState::NotTested),
+    outputHeadLines(-1),
     firstDiffLine(-1),
     outputLineCounts(0),
-    expectedLineCounts(0)
+    expectedLineCounts(0),
+    runCompleted(false),
+    performanceRegressed(false)
 {
     QUuid uid = QUuid::createUuid();
     id = uid.toString();
 }
 
+OJProblemCase::~OJProblemCase()
+{
+    if (!outputFileName.isEmpty())
+        QFile::remove(outputFileName);
+}
+
 const QString &OJProblemCase::getId() const
 {
     return id;
 }
 
+void OJProblemCase::recordRun(int regressionMargin)
+{
+    performanceRegressed = false;
+    if (regressionMargin>0 && runHistory.count()>=PROBLEM_CASE_REGRESSION_MIN_RUNS) {
+        qulonglong median = medianRunningTime();
+        qulonglong margin = std::max<qulonglong>(median*regressionMargin/100, PROBLEM_CASE_REGRESSION_MIN_DIFF);
+        performanceRegressed = (runningTime > median + margin);
+    }
+    OJProblemCaseRun run;
+    run.runningTime = runningTime;
+    run.runningMemory = runningMemory;
+    run.timestamp = QDateTime::currentMSecsSinceEpoch();
+    runHistory.append(run);
+    while (runHistory.count()>PROBLEM_CASE_RUN_HISTORY_SIZE)
+        runHistory.removeFirst();
+}
+
+qulonglong OJProblemCase::minRunningTime() const
+{
+    if (runHistory.isEmpty())
+        return 0;
+    qulonglong result = runHistory.front().runningTime;
+    foreach (const OJProblemCaseRun& run, runHistory)
+        result = std::min(result, run.runningTime);
+    return result;
+}
+
+qulonglong OJProblemCase::medianRunningTime() const
+{
+    QVector<qulonglong> values;
+    foreach (const OJProblemCaseRun& run, runHistory)
+        values.append(run.runningTime);
+    return medianOf(values);
+}
+
+qulonglong OJProblemCase::minRunningMemory() const
+{
+    if (runHistory.isEmpty())
+        return 0;
+    qulonglong result = runHistory.front().runningMemory;
+    foreach (const OJProblemCaseRun& run, runHistory)
+        result = std::min(result, run.runningMemory);
+    return result;
+}
+
+qulonglong OJProblemCase::medianRunningMemory() const
+{
+    QVector<qulonglong> values;
+    foreach (const OJProblemCaseRun& run, runHistory)
+        values.append(run.runningMemory);
+    return medianOf(values);
+}
+
 size_t OJProblem::getTimeLimit()
 {
     switch(timeLimitUnit) {
@@ -39,6 +39,12 @@ enum class ProblemMemoryLimitUnit {
     GB
 };
 
+struct OJProblemCaseRun {
+    qulonglong runningTime; // ms
+    qulonglong runningMemory; // bytes
+    qint64 timestamp; // ms since epoch
+};
+
 struct OJProblemCase {
     QString name;
     QString input;
@@ -46,16 +52,28 @@ struct OJProblemCase {
     QString inputFileName;
     QString expectedOutputFileName;
     ProblemCaseTestState testState; // no persistence
-    QString output; // no persistence
+    QString output; // no persistence; only the head and the tail when the output is large
+    QString outputFileName; // no persistence; the whole output
+    int outputHeadLines; // no persistence; lines at the start of output that are not truncated, -1 if output is whole
     qulonglong runningTime; // no persistence
     qulonglong runningMemory; // no persistence;
     int firstDiffLine; // no persistence
     int outputLineCounts; // no persistence
     int expectedLineCounts;
+    bool runCompleted; // no persistence; false if the last run failed, was stopped or exceeded the limits
+    bool performanceRegressed; // no persistence; slower than the median of its run history
+    QList<OJProblemCaseRun> runHistory; // recent runs, the oldest first
     OJProblemCase();
+    ~OJProblemCase();
 
 public:
     const QString &getId() const;
+    // append the last run to the history, and check it against the previous runs
+    void recordRun(int regressionMargin);
+    qulonglong minRunningTime() const;
+    qulonglong medianRunningTime() const;
+    qulonglong minRunningMemory() const;
+    qulonglong medianRunningMemory() const;
 
 private:
     QString id;
@@ -69,6 +87,8 @@ struct OJProblem {
     QString description;
     QString hint;
     QString answerProgram;
+    QString generatorProgram; // makes random inputs for stress test
+    QString bruteForceProgram; // makes the expected outputs for stress test
     size_t timeLimit;
     size_t memoryLimit;
     ProblemTimeLimitUnit timeLimitUnit;
@@ -16,94 +16,173 @@
  */
 #include "problemcasevalidator.h"
 
-ProblemCaseValidator::ProblemCaseValidator()
+#define LINE_COUNT_BUFFER_SIZE 65536
+
+ProblemCaseLineReader::ProblemCaseLineReader(const QString &text):
+    mText{text},
+    mPos{0},
+    mIsFile{false},
+    mLineCount{0},
+    mUtf8Decoder{TextDecoder::decoderForUtf8()},
+    mSystemDecoder{TextDecoder::decoderForSystem()}
 {
+}
 
+bool ProblemCaseLineReader::openFile(const QString &fileName)
+{
+    mText.clear();
+    mIsFile = true;
+    mFile.setFileName(fileName);
+    return mFile.open(QFile::ReadOnly);
 }
 
-bool ProblemCaseValidator::validate(POJProblemCase problemCase, ProblemCaseValidateType type)
+bool ProblemCaseLineReader::readLine(QString &line)
 {
-    if (!problemCase)
-        return false;
-    QStringList output = textToLines(problemCase->output);
-    QStringList expected;
-    if (fileExists(problemCase->expectedOutputFileName))
-        expected = readFileToLines(problemCase->expectedOutputFileName);
-    else
-        expected = textToLines(problemCase->expected);
-    problemCase->outputLineCounts = output.count();
-    problemCase->expectedLineCounts = expected.count();
-    if (problemCase->expectedLineCounts>5000) {
-        if (output.count()<expected.count()) {
-            problemCase->firstDiffLine=output.count();
-            return false;
-        }  else if (output.count()>expected.count()) {
-            problemCase->firstDiffLine=expected.count();
+    if (mIsFile) {
+        if (!mFile.isOpen() || mFile.atEnd())
             return false;
+        QByteArray s = mFile.readLine();
+        if (s.endsWith("\r\n")) {
+            s.remove(s.length()-2,2);
+        } else if (s.endsWith("\r")) {
+            s.remove(s.length()-1,1);
+        } else if (s.endsWith("\n")){
+            s.remove(s.length()-1,1);
         }
+        auto [ok, decoded] = mUtf8Decoder.decode(s);
+        line = ok ? decoded : mSystemDecoder.decodeUnchecked(s);
+    } else {
+        if (mPos >= mText.length())
+            return false;
+        int end = mText.indexOf('\n', mPos);
+        if (end < 0)
+            end = mText.length();
+        int len = end - mPos;
+        if (len > 0 && mText[end-1] == '\r')
+            len--;
+        line = mText.mid(mPos, len);
+        mPos = end + 1;
     }
-    int count=std::min(output.count(), expected.count());
-    switch(type) {
-    case ProblemCaseValidateType::Exact:
-        for (int i=0;i<count;i++) {
-            if (output[i]!=expected[i]) {
-                problemCase->firstDiffLine = i;
-                return false;
-            }
-        }
-        break;
-    case ProblemCaseValidateType::IgnoreLeadingTrailingSpaces:
-        for (int i=0;i<count;i++) {
-            if (output[i].trimmed()!=expected[i].trimmed()) {
-                problemCase->firstDiffLine = i;
-                return false;
+    mLineCount++;
+    return true;
+}
+
+int ProblemCaseLineReader::lineCount() const
+{
+    return mLineCount;
+}
+
+int ProblemCaseLineReader::countAllLines()
+{
+    if (mIsFile) {
+        if (!mFile.isOpen())
+            return mLineCount;
+        char buffer[LINE_COUNT_BUFFER_SIZE];
+        char last = '\n';
+        qint64 n;
+        while ((n = mFile.read(buffer, sizeof(buffer))) > 0) {
+            for (qint64 i=0;i<n;i++) {
+                if (buffer[i] == '\n')
+                    mLineCount++;
             }
+            last = buffer[n-1];
         }
-        break;
-    case ProblemCaseValidateType::IgnoreSpaces:
-        for (int i=0;i<count;i++) {
-            if (!equalIgnoringSpaces(output[i],expected[i])) {
-                problemCase->firstDiffLine = i;
-                return false;
+        //the last line isn't ended with a line break
+        if (last != '\n')
+            mLineCount++;
+    } else {
+        if (mPos < mText.length()) {
+            const QChar* p = mText.constData() + mPos;
+            const QChar* end = mText.constData() + mText.length();
+            for (;p<end;p++) {
+                if (*p == '\n')
+                    mLineCount++;
             }
+            if (!mText.endsWith('\n'))
+                mLineCount++;
+            mPos = mText.length();
         }
-        break;
     }
-    if (output.count()<expected.count()) {
-        problemCase->firstDiffLine=output.count();
-        return false;
-    }  else if (output.count()>expected.count()) {
-        problemCase->firstDiffLine=expected.count();
+    return mLineCount;
+}
+
+ProblemCaseValidator::ProblemCaseValidator()
+{
+
+}
+
+bool ProblemCaseValidator::validate(POJProblemCase problemCase, ProblemCaseValidateType type)
+{
+    if (!problemCase)
         return false;
+    ProblemCaseLineReader output(problemCase->output);
+    if (fileExists(problemCase->outputFileName))
+        output.openFile(problemCase->outputFileName);
+    ProblemCaseLineReader expected(problemCase->expected);
+    if (fileExists(problemCase->expectedOutputFileName))
+        expected.openFile(problemCase->expectedOutputFileName);
+    QString outputLine;
+    QString expectedLine;
+    bool result = true;
+    while (true) {
+        bool hasOutput = output.readLine(outputLine);
+        bool hasExpected = expected.readLine(expectedLine);
+        if (!hasOutput && !hasExpected)
+            break;
+        if (hasOutput != hasExpected) {
+            problemCase->firstDiffLine = std::min(output.lineCount(), expected.lineCount());
+            result = false;
+            break;
+        }
+        if (!equal(outputLine, expectedLine, type)) {
+            problemCase->firstDiffLine = output.lineCount() - 1;
+            result = false;
+            break;
+        }
     }
-    return true;
+    //the rest are only counted
+    problemCase->outputLineCounts = output.countAllLines();
+    problemCase->expectedLineCounts = expected.countAllLines();
+    return result;
 }
 
-bool ProblemCaseValidator::equalIgnoringSpaces(const QString &s1, const QString &s2)
+bool ProblemCaseValidator::equal(const QString &s1, const QString &s2, ProblemCaseValidateType type)
 {
-    QStringList strList1=split(s1);
-    QStringList strList2=split(s2);
-    return (strList1==strList2);
+    switch(type) {
+    case ProblemCaseValidateType::Exact:
+        return s1 == s2;
+    case ProblemCaseValidateType::IgnoreLeadingTrailingSpaces:
+        return QStringView(s1).trimmed() == QStringView(s2).trimmed();
+    case ProblemCaseValidateType::IgnoreSpaces:
+        return equalIgnoringSpaces(s1, s2);
+    }
+    return false;
 }
 
-QStringList ProblemCaseValidator::split(const QString &s)
+bool ProblemCaseValidator::equalIgnoringSpaces(const QString &s1, const QString &s2)
 {
-    QStringList result;
-    const QChar* p = getNullTerminatedStringData(s);
-    const QChar* start = p;
-    while (p->unicode()!=0) {
-        if (p->isSpace()) {
-            if (!start->isSpace()) {
-                result.append(QString(start,p-start));
-            }
-            start = p;
-        } else if (start->isSpace()) {
-            start = p;
+    //compare the words one by one, without splitting the lines
+    const QChar* p1 = s1.constData();
+    const QChar* end1 = p1 + s1.length();
+    const QChar* p2 = s2.constData();
+    const QChar* end2 = p2 + s2.length();
+    while (true) {
+        while (p1 < end1 && p1->isSpace())
+            p1++;
+        while (p2 < end2 && p2->isSpace())
+            p2++;
+        if (p1 == end1 || p2 == end2)
+            return p1 == end1 && p2 == end2;
+        while (p1 < end1 && p2 < end2 && !p1->isSpace() && !p2->isSpace()) {
+            if (*p1 != *p2)
+                return false;
+            p1++;
+            p2++;
         }
-        p++;
-    }
-    if (!start->isSpace()) {
-        result.append(QString(start,p-start));
+        //both words must end at the same place
+        bool wordEnded1 = (p1 == end1 || p1->isSpace());
+        bool wordEnded2 = (p2 == end2 || p2->isSpace());
+        if (!wordEnded1 || !wordEnded2)
+            return false;
     }
-    return result;
 }
@@ -17,17 +17,46 @@
 #ifndef PROBLEMCASEVALIDATOR_H
 #define PROBLEMCASEVALIDATOR_H
 
+#include <QFile>
 #include "ojproblemset.h"
 #include "../utils.h"
 
+/*
+ * Reads a text or a text file line by line, so that the whole file is never loaded.
+ * Lines are split the same way as textToLines()/readFileToLines().
+ */
+class ProblemCaseLineReader
+{
+public:
+    explicit ProblemCaseLineReader(const QString& text);
+    ProblemCaseLineReader(const ProblemCaseLineReader&)=delete;
+    ProblemCaseLineReader& operator=(const ProblemCaseLineReader&)=delete;
+
+    //read from the file instead of the text
+    bool openFile(const QString& fileName);
+    bool readLine(QString& line);
+    //lines read so far
+    int lineCount() const;
+    //reads to the end, and returns the total line count
+    int countAllLines();
+private:
+    QString mText;
+    int mPos;
+    QFile mFile;
+    bool mIsFile;
+    int mLineCount;
+    TextDecoder mUtf8Decoder;
+    TextDecoder mSystemDecoder;
+};
+
 class ProblemCaseValidator
 {
 public:
     ProblemCaseValidator();
     bool validate(POJProblemCase problemCase, ProblemCaseValidateType type);
 private:
+    bool equal(const QString& s1, const QString& s2, ProblemCaseValidateType type);
     bool equalIgnoringSpaces(const QString& s1, const QString& s2);
-    QStringList split(const QString& s);
 };
 
 #endif // PROBLEMCASEVALIDATOR_H
@@ -1213,6 +1213,9 @@ void Project::saveOptions()
     ini.SetLongValue("Project","ClassBrowserType", (int)mOptions.classBrowserType);
     ini.SetBoolValue("Project","AllowParallelBuilding",mOptions.allowParallelBuilding);
     ini.SetLongValue("Project","ParellelBuildingJobs",mOptions.parellelBuildingJobs);
+    ini.SetBoolValue("Project","UseNativeBuilder",mOptions.useNativeBuilder);
+    ini.SetBoolValue("Project","UseFastLinker",mOptions.useFastLinker);
+    ini.SetBoolValue("Project","SplitDebugInfo",mOptions.splitDebugInfo);
 
 
     //for Red Panda Dev C++ 6 compatibility
@@ -2096,6 +2099,9 @@ void Project::loadOptions(SimpleIni& ini)
 
         mOptions.allowParallelBuilding = ini.GetBoolValue("Project","AllowParallelBuilding");
         mOptions.parellelBuildingJobs = ini.GetLongValue("Project","ParellelBuildingJobs");
+        mOptions.useNativeBuilder = ini.GetBoolValue("Project","UseNativeBuilder", false);
+        mOptions.useFastLinker = ini.GetBoolValue("Project","UseFastLinker", false);
+        mOptions.splitDebugInfo = ini.GetBoolValue("Project","SplitDebugInfo", false);
 
 
         mOptions.versionInfo.major = ini.GetLongValue("VersionInfo", "Major", 0);
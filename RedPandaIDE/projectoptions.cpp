@@ -57,4 +57,7 @@ ProjectOptions::ProjectOptions()
     execEncoding = ENCODING_SYSTEM_DEFAULT;
     allowParallelBuilding=false;
     parellelBuildingJobs=0;
+    useNativeBuilder=false;
+    useFastLinker=false;
+    splitDebugInfo=false;
 }
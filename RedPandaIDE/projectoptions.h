@@ -101,5 +101,8 @@ struct ProjectOptions{
     ProjectClassBrowserType classBrowserType;
     bool allowParallelBuilding;
     int parellelBuildingJobs;
+    bool useNativeBuilder;
+    bool useFastLinker;
+    bool splitDebugInfo;
 };
 #endif // PROJECTOPTIONS_H
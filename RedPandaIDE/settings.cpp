@@ -21,6 +21,7 @@
 #include "utils/escape.h"
 #include "utils/font.h"
 #include "utils/parsearg.h"
+#include "compiler/compilerprobecache.h"
 #include <QDir>
 #include "systemconsts.h"
 #include <QDebug>
@@ -31,6 +32,8 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QThread>
+#include <QThreadPool>
 #ifdef Q_OS_LINUX
 #include <sys/sysinfo.h>
 #endif
@@ -39,6 +42,9 @@
 # include "addon/runtime.h"
 #endif
 
+#define COMPILER_PROBE_TIMEOUT 15000
+#define MAX_COMPILER_PROBE_JOBS 8
+
 const char ValueToChar[28] = {'0', '1', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h',
                               'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r',
                               's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
@@ -280,6 +286,11 @@ QString Settings::Dirs::config(Settings::Dirs::DataType dataType) const
     return "";
 }
 
+QString Settings::Dirs::cache() const
+{
+    return QFileInfo{includeTrailingPathDelimiter(config())+"cache"}.absoluteFilePath();
+}
+
 QString Settings::Dirs::executable() const
 {
     QString s = QApplication::instance()->applicationFilePath();
@@ -1619,6 +1630,8 @@ Settings::CompilerSet::CompilerSet():
     mAutoAddCharsetParams{false},
     mExecCharset{ENCODING_SYSTEM_DEFAULT},
     mStaticLink{false},
+    mUsePrecompiledHeader{false},
+    mUseObjectCache{false},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
     mPreprocessingSuffix{DEFAULT_PREPROCESSING_SUFFIX},
@@ -1635,6 +1648,8 @@ Settings::CompilerSet::CompilerSet(const QString& compilerFolder, const QString&
     mAutoAddCharsetParams{true},
     mExecCharset{ENCODING_SYSTEM_DEFAULT},
     mStaticLink{true},
+    mUsePrecompiledHeader{true},
+    mUseObjectCache{true},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
     mPreprocessingSuffix{DEFAULT_PREPROCESSING_SUFFIX},
@@ -1703,6 +1718,8 @@ Settings::CompilerSet::CompilerSet(const Settings::CompilerSet &set):
     mAutoAddCharsetParams{set.mAutoAddCharsetParams},
     mExecCharset{set.mExecCharset},
     mStaticLink{set.mStaticLink},
+    mUsePrecompiledHeader{set.mUsePrecompiledHeader},
+    mUseObjectCache{set.mUseObjectCache},
     mPersistInAutoFind{set.mPersistInAutoFind},
     mForceEnglishOutput{set.mForceEnglishOutput},
 
@@ -1747,6 +1764,8 @@ Settings::CompilerSet::CompilerSet(const QJsonObject &set) :
     mAutoAddCharsetParams{!set["execCharset"].toString().isEmpty()},
     mExecCharset{}, // handle later
     mStaticLink{set["staticLink"].toBool()},
+    mUsePrecompiledHeader{set["usePrecompiledHeader"].toBool()},
+    mUseObjectCache{set["useObjectCache"].toBool()},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
 
@@ -2811,12 +2830,16 @@ void Settings::CompilerSet::setUserInput()
     if (mCompilerType==CompilerType::SDCC) {
         mAutoAddCharsetParams = false;
         mStaticLink = false;
+        mUsePrecompiledHeader = false;
+        mUseObjectCache = false;
     } else {
 #else
     {
 #endif
         mAutoAddCharsetParams = true;
         mStaticLink = true;
+        mUsePrecompiledHeader = true;
+        mUseObjectCache = true;
     }
 }
 
@@ -2845,19 +2868,28 @@ void Settings::CompilerSet::setIniOptions(const QByteArray &value)
 
 QByteArray Settings::CompilerSet::getCompilerOutput(const QString &binDir, const QString &binFile, const QStringList &arguments)
 {
+    QString program = includeTrailingPathDelimiter(binDir)+binFile;
+    QByteArray output;
+    if (CompilerProbeCache::instance()->fetch(program, binDir, arguments, output))
+        return output;
     QProcessEnvironment env;
     env.insert("LANG","en");
     QString path = binDir;
     env.insert("PATH",path);
-    auto [result, _, errorMessage] = runAndGetOutput(
-                includeTrailingPathDelimiter(binDir)+binFile,
+    auto [result, _, errorMessage, exitCode] = runAndGetOutput(
+                program,
                 binDir,
                 arguments,
                 QByteArray(),
                 false,
                 false,
-                env);
-    return result.trimmed();
+                env,
+                COMPILER_PROBE_TIMEOUT);
+    output = result.trimmed();
+    //a failed probe is retried next time
+    if (errorMessage.isEmpty() && exitCode == 0)
+        CompilerProbeCache::instance()->store(program, binDir, arguments, output);
+    return output;
 }
 
 bool Settings::CompilerSet::forceEnglishOutput() const
@@ -3030,6 +3062,26 @@ void Settings::CompilerSet::setStaticLink(bool newStaticLink)
     mStaticLink = newStaticLink;
 }
 
+bool Settings::CompilerSet::usePrecompiledHeader() const
+{
+    return mUsePrecompiledHeader;
+}
+
+void Settings::CompilerSet::setUsePrecompiledHeader(bool newUsePrecompiledHeader)
+{
+    mUsePrecompiledHeader = newUsePrecompiledHeader;
+}
+
+bool Settings::CompilerSet::useObjectCache() const
+{
+    return mUseObjectCache;
+}
+
+void Settings::CompilerSet::setUseObjectCache(bool newUseObjectCache)
+{
+    mUseObjectCache = newUseObjectCache;
+}
+
 bool Settings::CompilerSet::useCustomCompileParams() const
 {
     return mUseCustomCompileParams;
@@ -3049,13 +3101,13 @@ Settings::PCompilerSet Settings::CompilerSets::addSet()
     return p;
 }
 
-Settings::PCompilerSet Settings::CompilerSets::addSet(const QString &folder, const QString& c_prog)
+bool Settings::CompilerSets::hasSet(const QString &folder, const QString &c_prog) const
 {
-    PCompilerSet p=std::make_shared<CompilerSet>(folder,c_prog);
-    if (c_prog==GCC_PROGRAM && p->compilerType()==CompilerType::Clang)
-        return PCompilerSet();
-    mList.push_back(p);
-    return p;
+    foreach (const PCompilerSet& set, mList) {
+        if (set->binDirs().contains(folder) && extractFileName(set->CCompiler())==c_prog)
+            return true;
+    }
+    return false;
 }
 
 Settings::PCompilerSet Settings::CompilerSets::addSet(const PCompilerSet &pSet)
@@ -3104,14 +3156,22 @@ static void setDebugOptions(Settings::PCompilerSet pSet, bool enableAsan = false
 }
 
 bool Settings::CompilerSets::addSets(const QString &folder, const QString& c_prog) {
-    foreach (const PCompilerSet& set, mList) {
-        if (set->binDirs().contains(folder) && extractFileName(set->CCompiler())==c_prog)
-            return false;
-    }
-    // Default, release profile
-    PCompilerSet baseSet = addSet(folder,c_prog);
-    if (!baseSet || baseSet->name().isEmpty())
+    if (hasSet(folder,c_prog))
+        return false;
+    return addSets(folder, c_prog, std::make_shared<CompilerSet>(folder,c_prog));
+}
+
+bool Settings::CompilerSets::addSets(const QString &folder, const QString &c_prog, const PCompilerSet &probedSet)
+{
+    if (hasSet(folder,c_prog))
+        return false;
+    if (!probedSet || probedSet->name().isEmpty())
         return false;
+    if (c_prog==GCC_PROGRAM && probedSet->compilerType()==CompilerType::Clang)
+        return false;
+    // Default, release profile
+    PCompilerSet baseSet = probedSet;
+    mList.push_back(baseSet);
 #if ENABLE_SDCC
     if (c_prog == SDCC_PROGRAM) {
         baseSet->setCompileOption(SDCC_OPT_NOSTARTUP,COMPILER_OPTION_ON);
@@ -3209,6 +3269,8 @@ Settings::CompilerSetList Settings::CompilerSets::clearSets()
 
 void Settings::CompilerSets::findSets()
 {
+    //compilers found again are probed again
+    CompilerProbeCache::instance()->clear();
     CompilerSetList persisted = clearSets();
     // canonical paths that has been searched.
     // use canonical paths here to resolve symbolic links.
@@ -3257,6 +3319,7 @@ void Settings::CompilerSets::findSets()
     };//  + pathList;
 #endif
     QString folder, canonicalFolder;
+    QList<QPair<QString,QString>> candidates;
     for (int i=pathList.count()-1;i>=0;i--) {
         folder = QDir(pathList[i]).absolutePath();
         canonicalFolder = QDir(pathList[i]).canonicalPath();
@@ -3270,7 +3333,32 @@ void Settings::CompilerSets::findSets()
         //   /opt/gcc-13 -> /opt/gcc-13.1.0
         // after upgrade:
         //   /opt/gcc-13 -> /opt/gcc-13.2.0
-        addSets(folder);
+        if (fileExists(folder, GCC_PROGRAM))
+            candidates.append(qMakePair(folder,QString(GCC_PROGRAM)));
+        if (fileExists(folder, CLANG_PROGRAM))
+            candidates.append(qMakePair(folder,QString(CLANG_PROGRAM)));
+#ifdef ENABLE_SDCC
+        if (fileExists(folder, SDCC_PROGRAM))
+            candidates.append(qMakePair(folder,QString(SDCC_PROGRAM)));
+#endif
+    }
+
+    // Probe all candidates concurrently, then add them in the search order,
+    // so the resulting list (and the default set) doesn't depend on which probe finishes first.
+    QVector<PCompilerSet> probedSets(candidates.count());
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount(), MAX_COMPILER_PROBE_JOBS)));
+    for (int i=0;i<candidates.count();i++) {
+        QString candidateFolder = candidates[i].first;
+        QString candidateProgram = candidates[i].second;
+        PCompilerSet* result = &probedSets[i];
+        pool.start(QRunnable::create([candidateFolder, candidateProgram, result](){
+            *result = std::make_shared<CompilerSet>(candidateFolder, candidateProgram);
+        }));
+    }
+    pool.waitForDone();
+    for (int i=0;i<candidates.count();i++) {
+        addSets(candidates[i].first, candidates[i].second, probedSets[i]);
     }
 
 #ifdef ENABLE_LUA_ADDON
@@ -3514,6 +3602,8 @@ void Settings::CompilerSets::saveSet(int index)
     mSettings->mSettings.setValue("customLinkParams", pSet->customLinkParams());
     mSettings->mSettings.setValue("AddCharset", pSet->autoAddCharsetParams());
     mSettings->mSettings.setValue("StaticLink", pSet->staticLink());
+    mSettings->mSettings.setValue("UsePrecompiledHeader", pSet->usePrecompiledHeader());
+    mSettings->mSettings.setValue("UseObjectCache", pSet->useObjectCache());
     mSettings->mSettings.setValue("ExecCharset", pSet->execCharset());
     mSettings->mSettings.setValue("PersistInAutoFind", pSet->persistInAutoFind());
     mSettings->mSettings.setValue("forceEnglishOutput", pSet->forceEnglishOutput());
@@ -3606,6 +3696,8 @@ Settings::PCompilerSet Settings::CompilerSets::loadSet(int index)
     pSet->setCustomLinkParams(mSettings->mSettings.value("customLinkParams").toString());
     pSet->setAutoAddCharsetParams(mSettings->mSettings.value("AddCharset", true).toBool());
     pSet->setStaticLink(mSettings->mSettings.value("StaticLink", false).toBool());
+    pSet->setUsePrecompiledHeader(mSettings->mSettings.value("UsePrecompiledHeader", true).toBool());
+    pSet->setUseObjectCache(mSettings->mSettings.value("UseObjectCache", true).toBool());
     pSet->setPersistInAutoFind(mSettings->mSettings.value("PersistInAutoFind", false).toBool());
     bool forceEnglishOutput=QLocale::system().name().startsWith("zh")?false:true;
     pSet->setForceEnglishOutput(mSettings->mSettings.value("forceEnglishOutput", forceEnglishOutput).toBool());
@@ -4134,6 +4226,16 @@ void Settings::Executor::setMinimizeOnRun(bool minimizeOnRun)
     mMinimizeOnRun = minimizeOnRun;
 }
 
+bool Settings::Executor::logRunStatistics() const
+{
+    return mLogRunStatistics;
+}
+
+void Settings::Executor::setLogRunStatistics(bool newLogRunStatistics)
+{
+    mLogRunStatistics = newLogRunStatistics;
+}
+
 bool Settings::Executor::useParams() const
 {
     return mUseParams;
@@ -4254,6 +4356,36 @@ void Settings::Executor::setEnableVirualTerminalSequence(bool newEnableVirualTer
     mEnableVirualTerminalSequence = newEnableVirualTerminalSequence;
 }
 
+bool Settings::Executor::runCasesInParallel() const
+{
+    return mRunCasesInParallel;
+}
+
+void Settings::Executor::setRunCasesInParallel(bool newRunCasesInParallel)
+{
+    mRunCasesInParallel = newRunCasesInParallel;
+}
+
+int Settings::Executor::parallelCaseJobs() const
+{
+    return mParallelCaseJobs;
+}
+
+void Settings::Executor::setParallelCaseJobs(int newParallelCaseJobs)
+{
+    mParallelCaseJobs = newParallelCaseJobs;
+}
+
+int Settings::Executor::caseRegressionMargin() const
+{
+    return mCaseRegressionMargin;
+}
+
+void Settings::Executor::setCaseRegressionMargin(int newCaseRegressionMargin)
+{
+    mCaseRegressionMargin = newCaseRegressionMargin;
+}
+
 bool Settings::Executor::convertHTMLToTextForInput() const
 {
     return mConvertHTMLToTextForInput;
@@ -4321,6 +4453,7 @@ void Settings::Executor::doSave()
     saveValue("enable_virtual_terminal_sequence", mEnableVirualTerminalSequence);
 #endif
     saveValue("minimize_on_run", mMinimizeOnRun);
+    saveValue("log_run_statistics", mLogRunStatistics);
     saveValue("use_params",mUseParams);
     saveValue("params",mParams);
     saveValue("redirect_input",mRedirectInput);
@@ -4340,6 +4473,9 @@ void Settings::Executor::doSave()
     saveValue("case_memory_limit",mCaseMemoryLimit);
     remove("case_timeout");
     saveValue("enable_case_limit", mEnableCaseLimit);
+    saveValue("run_cases_in_parallel", mRunCasesInParallel);
+    saveValue("parallel_case_jobs", mParallelCaseJobs);
+    saveValue("case_regression_margin", mCaseRegressionMargin);
 }
 
 bool Settings::Executor::pauseConsole() const
@@ -4359,6 +4495,7 @@ void Settings::Executor::doLoad()
     mEnableVirualTerminalSequence = boolValue("enable_virtual_terminal_sequence", true);
 #endif
     mMinimizeOnRun = boolValue("minimize_on_run",false);
+    mLogRunStatistics = boolValue("log_run_statistics",false);
     mUseParams = boolValue("use_params",false);
     mParams = stringValue("params", "");
     mRedirectInput = boolValue("redirect_input",false);
@@ -4387,6 +4524,9 @@ void Settings::Executor::doLoad()
     if (boolValue("enable_time_limit", true)) {
         mEnableCaseLimit=true;
     }
+    mRunCasesInParallel = boolValue("run_cases_in_parallel", false);
+    mParallelCaseJobs = intValue("parallel_case_jobs", 0);
+    mCaseRegressionMargin = intValue("case_regression_margin", 20);
 }
 
 
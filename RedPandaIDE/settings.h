@@ -105,6 +105,7 @@ public:
         QString projectDir() const;
         QString data(DataType dataType = DataType::None) const;
         QString config(DataType dataType = DataType::None) const;
+        QString cache() const;
         QString executable() const;
 
         void setProjectDir(const QString &newProjectDir);
@@ -898,6 +899,9 @@ public:
         bool minimizeOnRun() const;
         void setMinimizeOnRun(bool minimizeOnRun);
 
+        bool logRunStatistics() const;
+        void setLogRunStatistics(bool newLogRunStatistics);
+
         bool useParams() const;
         void setUseParams(bool newUseParams);
         const QString &params() const;
@@ -948,10 +952,20 @@ public:
 
         bool enableVirualTerminalSequence() const;
         void setEnableVirualTerminalSequence(bool newEnableVirualTerminalSequence);
+
+        bool runCasesInParallel() const;
+        void setRunCasesInParallel(bool newRunCasesInParallel);
+
+        int parallelCaseJobs() const;
+        void setParallelCaseJobs(int newParallelCaseJobs);
+
+        int caseRegressionMargin() const;
+        void setCaseRegressionMargin(int newCaseRegressionMargin);
     private:
         // general
         bool mPauseConsole;
         bool mMinimizeOnRun;
+        bool mLogRunStatistics;
         bool mUseParams;
         QString mParams;
         bool mRedirectInput;
@@ -973,6 +987,9 @@ public:
         bool mEnableCaseLimit;
         qulonglong mCaseTimeout; //ms
         qulonglong mCaseMemoryLimit; //kb
+        bool mRunCasesInParallel;
+        int mParallelCaseJobs; // 0: physical cores - 1
+        int mCaseRegressionMargin; // percent over the median running time, 0: don't check
 
     protected:
         void doSave() override;
@@ -1422,6 +1439,12 @@ public:
         bool staticLink() const;
         void setStaticLink(bool newStaticLink);
 
+        bool usePrecompiledHeader() const;
+        void setUsePrecompiledHeader(bool newUsePrecompiledHeader);
+
+        bool useObjectCache() const;
+        void setUseObjectCache(bool newUseObjectCache);
+
 
         static int charToValue(char valueChar);
         static char valueToChar(int val);
@@ -1520,6 +1543,8 @@ public:
         bool mAutoAddCharsetParams;
         QString mExecCharset;
         bool mStaticLink;
+        bool mUsePrecompiledHeader;
+        bool mUseObjectCache;
         bool mPersistInAutoFind;
         bool mForceEnglishOutput;
 
@@ -1561,7 +1586,8 @@ public:
 
         static bool isTarget64Bit(const QString &target);
     private:
-        PCompilerSet addSet(const QString& folder, const QString& c_prog);
+        bool hasSet(const QString& folder, const QString& c_prog) const;
+        bool addSets(const QString& folder, const QString& c_prog, const PCompilerSet& probedSet);
         PCompilerSet addSet(const PCompilerSet &pSet);
         PCompilerSet addSet(const QJsonObject &set);
         void savePath(const QString& name, const QString& path);
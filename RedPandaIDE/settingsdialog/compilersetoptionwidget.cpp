@@ -87,6 +87,12 @@ static void loadCompilerSetSettings(Settings::PCompilerSet pSet, Ui::CompilerSet
     ui->chkStaticLink->setEnabled(supportStaticLink);
     ui->chkStaticLink->setVisible(supportStaticLink);
 
+    bool supportPrecompiledHeader = CompilerInfoManager::supportPrecompiledHeader(pSet->compilerType());
+    ui->chkUsePrecompiledHeader->setEnabled(supportPrecompiledHeader);
+    ui->chkUsePrecompiledHeader->setVisible(supportPrecompiledHeader);
+    ui->chkUseObjectCache->setEnabled(supportPrecompiledHeader);
+    ui->chkUseObjectCache->setVisible(supportPrecompiledHeader);
+
     ui->chkUseCustomCompilerParams->setChecked(pSet->useCustomCompileParams());
     ui->txtCustomCompileParams->setPlainText(pSet->customCompileParams());
     ui->txtCustomCompileParams->setEnabled(pSet->useCustomCompileParams());
@@ -95,6 +101,8 @@ static void loadCompilerSetSettings(Settings::PCompilerSet pSet, Ui::CompilerSet
     ui->txtCustomLinkParams->setEnabled(pSet->useCustomLinkParams());
     ui->chkAutoAddCharset->setChecked(pSet->autoAddCharsetParams());
     ui->chkStaticLink->setChecked(pSet->staticLink());
+    ui->chkUsePrecompiledHeader->setChecked(pSet->usePrecompiledHeader());
+    ui->chkUseObjectCache->setChecked(pSet->useObjectCache());
     ui->chkPersistInAutoFind->setChecked(pSet->persistInAutoFind());
     ui->chkForceEnglishOutput->setChecked(pSet->forceEnglishOutput());
     //rest tabs in the options widget
@@ -240,6 +248,8 @@ void CompilerSetOptionWidget::saveCurrentCompilerSet()
     pSet->setCustomLinkParams(ui->txtCustomLinkParams->toPlainText().trimmed());
     pSet->setAutoAddCharsetParams(ui->chkAutoAddCharset->isChecked());
     pSet->setStaticLink(ui->chkStaticLink->isChecked());
+    pSet->setUsePrecompiledHeader(ui->chkUsePrecompiledHeader->isChecked());
+    pSet->setUseObjectCache(ui->chkUseObjectCache->isChecked());
     pSet->setPersistInAutoFind(ui->chkPersistInAutoFind->isChecked());
     pSet->setForceEnglishOutput(ui->chkForceEnglishOutput->isChecked());
 
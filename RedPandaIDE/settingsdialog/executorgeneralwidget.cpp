@@ -52,6 +52,7 @@ void ExecutorGeneralWidget::doLoad()
     ui->chkVTSeq->setChecked(pSettings->executor().enableVirualTerminalSequence());
 #endif
     ui->chkMinimizeOnRun->setChecked(pSettings->executor().minimizeOnRun());
+    ui->chkLogRunStatistics->setChecked(pSettings->executor().logRunStatistics());
     ui->grpExecuteParameters->setChecked(pSettings->executor().useParams());
     ui->txtExecuteParamaters->setText(pSettings->executor().params());
     ui->grpRedirectInput->setChecked(pSettings->executor().redirectInput());
@@ -65,6 +66,7 @@ void ExecutorGeneralWidget::doSave()
     pSettings->executor().setEnableVirualTerminalSequence(ui->chkVTSeq->isChecked());
 #endif
     pSettings->executor().setMinimizeOnRun(ui->chkMinimizeOnRun->isChecked());
+    pSettings->executor().setLogRunStatistics(ui->chkLogRunStatistics->isChecked());
     pSettings->executor().setUseParams(ui->grpExecuteParameters->isChecked());
     pSettings->executor().setParams(ui->txtExecuteParamaters->text());
     pSettings->executor().setRedirectInput(ui->grpRedirectInput->isChecked());
@@ -53,6 +53,9 @@ void ExecutorProblemSetWidget::doLoad()
 
     ui->spinCaseTimeout->setValue(pSettings->executor().caseTimeout());
     ui->spinMemoryLimit->setValue(pSettings->executor().caseMemoryLimit());
+    ui->grpRunCasesInParallel->setChecked(pSettings->executor().runCasesInParallel());
+    ui->spinParallelCaseJobs->setValue(pSettings->executor().parallelCaseJobs());
+    ui->spinCaseRegressionMargin->setValue(pSettings->executor().caseRegressionMargin());
 }
 
 void ExecutorProblemSetWidget::doSave()
@@ -70,6 +73,9 @@ void ExecutorProblemSetWidget::doSave()
     pSettings->executor().setEnableCaseLimit(ui->grpEnableTimeout->isChecked());
     pSettings->executor().setCaseTimeout(ui->spinCaseTimeout->value());
     pSettings->executor().setCaseMemoryLimit(ui->spinMemoryLimit->value());
+    pSettings->executor().setRunCasesInParallel(ui->grpRunCasesInParallel->isChecked());
+    pSettings->executor().setParallelCaseJobs(ui->spinParallelCaseJobs->value());
+    pSettings->executor().setCaseRegressionMargin(ui->spinCaseRegressionMargin->value());
 
     pSettings->executor().save();
     pMainWindow->applySettings();
@@ -338,7 +338,7 @@ void FormatterGeneralWidget::updateDemo()
 
     Settings::CodeFormatter formatter(nullptr);
     updateCodeFormatter(formatter);
-    auto [newContent, astyleError, processError] =
+    auto [newContent, astyleError, processError, exitCode] =
         runAndGetOutput(astyle, extractFileDir(astyle), formatter.getArguments(), content, true);
     QString display;
     if (!processError.isEmpty())
@@ -56,6 +56,9 @@ void ProjectCompileParamatersWidget::doLoad()
     ui->txtResource->setPlainText(pMainWindow->project()->options().resourceCmd);
     ui->grpAllowParallelBuilding->setChecked(pMainWindow->project()->options().allowParallelBuilding);
     ui->spinParallelJobs->setValue(pMainWindow->project()->options().parellelBuildingJobs);
+    ui->chkUseNativeBuilder->setChecked(pMainWindow->project()->options().useNativeBuilder);
+    ui->chkUseFastLinker->setChecked(pMainWindow->project()->options().useFastLinker);
+    ui->chkSplitDebugInfo->setChecked(pMainWindow->project()->options().splitDebugInfo);
 }
 
 void ProjectCompileParamatersWidget::doSave()
@@ -66,6 +69,9 @@ void ProjectCompileParamatersWidget::doSave()
     pMainWindow->project()->options().resourceCmd = ui->txtResource->toPlainText();
     pMainWindow->project()->options().allowParallelBuilding = ui->grpAllowParallelBuilding->isChecked();
     pMainWindow->project()->options().parellelBuildingJobs = ui->spinParallelJobs->value();
+    pMainWindow->project()->options().useNativeBuilder = ui->chkUseNativeBuilder->isChecked();
+    pMainWindow->project()->options().useFastLinker = ui->chkUseFastLinker->isChecked();
+    pMainWindow->project()->options().splitDebugInfo = ui->chkSplitDebugInfo->isChecked();
     pMainWindow->project()->saveOptions();
 }
 
@@ -29,6 +29,10 @@
 #define GDB32_PROGRAM   "gdb32.exe"
 #define MAKE_PROGRAM    "mingw32-make.exe"
 #define WINDRES_PROGRAM "windres.exe"
+#define AR_PROGRAM      "ar.exe"
+#define MOLD_LINKER_PROGRAM ""
+#define LLD_LINKER_PROGRAM  "ld.lld.exe"
+#define GOLD_LINKER_PROGRAM ""
 #define CLEAN_PROGRAM   "del /q /f"
 #define CD_PROGRAM   "cd /d"
 #define CPP_PROGRAM     "cpp.exe"
@@ -50,6 +54,10 @@
 #define GDB32_PROGRAM   "gdb32"
 #define MAKE_PROGRAM    "make"
 #define WINDRES_PROGRAM ""
+#define AR_PROGRAM      "ar"
+#define MOLD_LINKER_PROGRAM "ld.mold"
+#define LLD_LINKER_PROGRAM  "ld.lld"
+#define GOLD_LINKER_PROGRAM "ld.gold"
 #define GPROF_PROGRAM   "gprof"
 #define CLEAN_PROGRAM   "rm -rf"
 #define CD_PROGRAM   "cd"
@@ -72,6 +80,8 @@
 #define RES_EXT "res"
 #define H_EXT "h"
 #define OBJ_EXT "o"
+#define DEP_EXT "d"
+#define DWO_EXT "dwo"
 #define LST_EXT "lst"
 #define DEF_EXT "def"
 #define LIB_EXT "a"
@@ -20,6 +20,8 @@
 #include "editorlist.h"
 
 #include <QRegularExpression>
+#include <QFileInfo>
+#include <QThreadPool>
 
 
 static QRegularExpression todoReg("\\b(todo|fixme)\\b", QRegularExpression::CaseInsensitiveOption);
@@ -27,6 +29,7 @@ TodoParser::TodoParser(QObject *parent) : QObject(parent),
     mMutex()
 {
     mThread = nullptr;
+    mCache = std::make_shared<TodoCache>();
 }
 
 void TodoParser::parseFile(const QString &filename,bool isForProject)
@@ -35,7 +38,7 @@ void TodoParser::parseFile(const QString &filename,bool isForProject)
     if (mThread) {
         return;
     }
-    mThread = new TodoThread(filename);
+    mThread = new TodoThread(filename, mCache, getOpenedContents(QStringList{filename}));
     connect(mThread,&QThread::finished,
             [this] {
         QMutexLocker locker(&mMutex);
@@ -48,10 +51,8 @@ void TodoParser::parseFile(const QString &filename,bool isForProject)
         connect(mThread, &TodoThread::parseStarted,
             pMainWindow, &MainWindow::onTodoParseStarted);
     }
-    connect(mThread, &TodoThread::parsingFile,
-            pMainWindow, &MainWindow::onTodoParsingFile);
-    connect(mThread, &TodoThread::todoFound,
-            pMainWindow, &MainWindow::onTodoFound);
+    connect(mThread, &TodoThread::todosFound,
+            pMainWindow, &MainWindow::onTodosFound);
     connect(mThread, &TodoThread::parseFinished,
             pMainWindow, &MainWindow::onTodoParseFinished);
     mThread->start();
@@ -63,7 +64,7 @@ void TodoParser::parseFiles(const QStringList &files)
     if (mThread) {
         return;
     }
-    mThread = new TodoThread(files);
+    mThread = new TodoThread(files, mCache, getOpenedContents(files));
     connect(mThread,&QThread::finished,
             [this] {
         QMutexLocker locker(&mMutex);
@@ -74,10 +75,8 @@ void TodoParser::parseFiles(const QStringList &files)
     });
     connect(mThread, &TodoThread::parseStarted,
             pMainWindow, &MainWindow::onTodoParseStarted);
-    connect(mThread, &TodoThread::parsingFile,
-            pMainWindow, &MainWindow::onTodoParsingFile);
-    connect(mThread, &TodoThread::todoFound,
-            pMainWindow, &MainWindow::onTodoFound);
+    connect(mThread, &TodoThread::todosFound,
+            pMainWindow, &MainWindow::onTodosFound);
     connect(mThread, &TodoThread::parseFinished,
             pMainWindow, &MainWindow::onTodoParseFinished);
     mThread->start();
@@ -88,16 +87,34 @@ bool TodoParser::parsing() const
     return (mThread!=nullptr);
 }
 
-TodoThread::TodoThread(const QString &filename, QObject *parent): QThread(parent)
+QHash<QString, QStringList> TodoParser::getOpenedContents(const QStringList &files)
+{
+    //editors can only be accessed in the gui thread
+    QHash<QString,QStringList> contents;
+    foreach (const QString& filename, files) {
+        QStringList lines;
+        if (pMainWindow->editorList()->getContentFromOpenedEditor(filename,lines))
+            contents.insert(filename,lines);
+    }
+    return contents;
+}
+
+TodoThread::TodoThread(const QString &filename, PTodoCache cache,
+                       const QHash<QString,QStringList>& openedContents, QObject *parent): QThread(parent)
 {
     mFilename = filename;
     mParseFiles = false;
+    mCache = cache;
+    mOpenedContents = openedContents;
 }
 
-TodoThread::TodoThread(const QStringList &files, QObject *parent): QThread(parent)
+TodoThread::TodoThread(const QStringList &files, PTodoCache cache,
+                       const QHash<QString,QStringList>& openedContents, QObject *parent): QThread(parent)
 {
     mFiles = files;
     mParseFiles = true;
+    mCache = cache;
+    mOpenedContents = openedContents;
 }
 
 void TodoThread::parseFile()
@@ -110,21 +127,48 @@ void TodoThread::parseFile()
 
 void TodoThread::parseFiles()
 {
-    QSynedit::PSyntaxer highlighter = syntaxerManager.getSyntaxer(QSynedit::ProgrammingLanguage::CPP);
     emit parseStarted();
-    foreach(const QString& filename,mFiles) {
-        doParseFile(filename,highlighter);
+    //each worker scans every n-th file with its own syntaxer
+    QThreadPool pool;
+    int workers = std::max(1, std::min(QThread::idealThreadCount(), mFiles.count()));
+    pool.setMaxThreadCount(workers);
+    for (int w=0;w<workers;w++) {
+        pool.start(QRunnable::create([this,w,workers]{
+            QSynedit::PSyntaxer syntaxer = syntaxerManager.getSyntaxer(QSynedit::ProgrammingLanguage::CPP);
+            for (int i=w;i<mFiles.count();i+=workers) {
+                doParseFile(mFiles[i],syntaxer);
+            }
+        }));
     }
+    pool.waitForDone();
     emit parseFinished();
 }
 
 void TodoThread::doParseFile(const QString &filename, QSynedit::PSyntaxer syntaxer)
 {
-    emit parsingFile(filename);
-    QStringList lines;
-    if (!pMainWindow->editorList()->getContentFromOpenedEditor(filename,lines)) {
-        lines = readFileToLines(filename);
+    QList<PTodoItem> items;
+    auto it = mOpenedContents.constFind(filename);
+    if (it != mOpenedContents.constEnd()) {
+        //editor contents may differ from the disk file, don't cache them
+        items = scanLines(filename, it.value(), syntaxer);
+    } else {
+        QFileInfo info(filename);
+        qint64 size = info.size();
+        QDateTime lastModified = info.lastModified();
+        if (!mCache->find(filename, size, lastModified, items)) {
+            QStringList lines = readFileToLines(filename);
+            items = scanLines(filename, lines, syntaxer);
+            mCache->insert(filename, size, lastModified, items);
+        }
     }
+    //the model is cleared before scanning a file list
+    if (!mParseFiles || !items.isEmpty())
+        emit todosFound(filename, items);
+}
+
+QList<PTodoItem> TodoThread::scanLines(const QString &filename, const QStringList &lines, QSynedit::PSyntaxer syntaxer)
+{
+    QList<PTodoItem> items;
     syntaxer->resetState();
     for (int i =0;i<lines.count();i++) {
         syntaxer->setLine(lines[i],i);
@@ -135,19 +179,19 @@ void TodoThread::doParseFile(const QString &filename, QSynedit::PSyntaxer syntax
                 QString token = syntaxer->getToken();
                 int pos = token.indexOf(todoReg);
                 if (pos>=0) {
-                    emit todoFound(
-                                filename,
-                                i+1,
-                                pos+syntaxer->getTokenPos(),
-                                lines[i].trimmed()
-                                );
+                    PTodoItem item = std::make_shared<TodoItem>();
+                    item->filename = filename;
+                    item->lineNo = i+1;
+                    item->ch = pos+syntaxer->getTokenPos();
+                    item->line = lines[i].trimmed();
+                    items.append(item);
                     break;
                 }
             }
             syntaxer->next();
         }
     }
-
+    return items;
 }
 
 void TodoThread::run()
@@ -164,33 +208,36 @@ TodoModel::TodoModel(QObject *parent) : QAbstractListModel(parent)
     mIsForProject=false;
 }
 
-void TodoModel::addItem(const QString &filename, int lineNo, int ch, const QString &line)
+void TodoModel::replaceTodosForFile(const QString &filename, const QList<PTodoItem> &newItems)
 {
     QList<PTodoItem> &items=getItems(mIsForProject);
-    int pos=-1;
+    //items are sorted by filename, so todos of a file are contiguous
+    int first=-1;
+    int last=-1;
+    int pos=items.count();
     for (int i=0;i<items.count();i++) {
         int comp=QString::compare(filename,items[i]->filename);
-        if (comp<0) {
+        if (comp==0) {
+            if (first<0)
+                first=i;
+            last=i;
+        } else if (comp<0) {
             pos=i;
             break;
-        } else if (comp==0) {
-            if (lineNo<items[i]->lineNo)  {
-                pos=i;
-                break;
-            }
         }
     }
-    if (pos<0) {
-        pos=items.count();
+    if (first>=0) {
+        beginRemoveRows(QModelIndex(),first,last);
+        items.erase(items.begin()+first,items.begin()+last+1);
+        endRemoveRows();
+        pos=first;
+    }
+    if (!newItems.isEmpty()) {
+        beginInsertRows(QModelIndex(),pos,pos+newItems.count()-1);
+        for (int i=0;i<newItems.count();i++)
+            items.insert(pos+i,newItems[i]);
+        endInsertRows();
     }
-    beginInsertRows(QModelIndex(),pos,pos);
-    PTodoItem item = std::make_shared<TodoItem>();
-    item->filename = filename;
-    item->lineNo = lineNo;
-    item->ch = ch;
-    item->line = line;
-    items.insert(pos,item);
-    endInsertRows();
 }
 
 void TodoModel::removeTodosForFile(const QString &filename)
@@ -299,3 +346,25 @@ int TodoModel::columnCount(const QModelIndex &) const
 {
     return 3;
 }
+
+bool TodoCache::find(const QString &filename, qint64 size, const QDateTime &lastModified, QList<PTodoItem> &items)
+{
+    QMutexLocker locker(&mMutex);
+    auto it = mEntries.constFind(filename);
+    if (it == mEntries.constEnd())
+        return false;
+    if (it->size != size || it->lastModified != lastModified)
+        return false;
+    items = it->items;
+    return true;
+}
+
+void TodoCache::insert(const QString &filename, qint64 size, const QDateTime &lastModified, const QList<PTodoItem> &items)
+{
+    QMutexLocker locker(&mMutex);
+    TodoCacheEntry entry;
+    entry.size = size;
+    entry.lastModified = lastModified;
+    entry.items = items;
+    mEntries.insert(filename,entry);
+}
@@ -20,6 +20,8 @@
 #include <QObject>
 #include <QThread>
 #include <QMutex>
+#include <QHash>
+#include <QDateTime>
 #include <QAbstractListModel>
 #include "syntaxermanager.h"
 #include "qsynedit/constants.h"
@@ -33,12 +35,36 @@ struct TodoItem {
 
 using PTodoItem = std::shared_ptr<TodoItem>;
 
+Q_DECLARE_METATYPE(PTodoItem);
+
+struct TodoCacheEntry {
+    qint64 size;
+    QDateTime lastModified;
+    QList<PTodoItem> items;
+};
+
+/**
+ * @brief Per-file todo scan results, keyed by path, size and modification time.
+ * Shared by all todo threads, so it must be thread safe.
+ */
+class TodoCache {
+public:
+    bool find(const QString& filename, qint64 size, const QDateTime& lastModified,
+              QList<PTodoItem>& items);
+    void insert(const QString& filename, qint64 size, const QDateTime& lastModified,
+                const QList<PTodoItem>& items);
+private:
+    QHash<QString,TodoCacheEntry> mEntries;
+    QMutex mMutex;
+};
+
+using PTodoCache = std::shared_ptr<TodoCache>;
+
 class TodoModel : public QAbstractListModel {
     Q_OBJECT
 public:
     explicit TodoModel(QObject* parent=nullptr);
-    void addItem(const QString& filename, int lineNo,
-                 int ch, const QString& line);
+    void replaceTodosForFile(const QString& filename, const QList<PTodoItem>& newItems);
     void removeTodosForFile(const QString& filename);
     void clear();
     void clear(bool forProject);
@@ -66,21 +92,27 @@ class TodoThread: public QThread
 {
     Q_OBJECT
 public:
-    explicit TodoThread(const QString& filename, QObject* parent = nullptr);
-    explicit TodoThread(const QStringList& files, QObject* parent = nullptr);
+    explicit TodoThread(const QString& filename, PTodoCache cache,
+                        const QHash<QString,QStringList>& openedContents, QObject* parent = nullptr);
+    explicit TodoThread(const QStringList& files, PTodoCache cache,
+                        const QHash<QString,QStringList>& openedContents, QObject* parent = nullptr);
 signals:
     void parseStarted();
-    void parsingFile(const QString& fileName);
-    void todoFound(const QString& filename, int lineNo, int ch, const QString& line);
+    void todosFound(const QString& filename, const QList<PTodoItem>& items);
     void parseFinished();
 private:
     void parseFile();
     void parseFiles();
     void doParseFile(const QString& filename, QSynedit::PSyntaxer syntaxer);
+    QList<PTodoItem> scanLines(const QString& filename, const QStringList& lines,
+                               QSynedit::PSyntaxer syntaxer);
 private:
     QString mFilename;
     QStringList mFiles;
     bool mParseFiles;
+    PTodoCache mCache;
+    //contents of the files opened in editors, copied in the gui thread
+    QHash<QString,QStringList> mOpenedContents;
 
     // QThread interface
 protected:
@@ -98,8 +130,11 @@ public:
     void parseFiles(const QStringList& files);
     bool parsing() const;
 
+private:
+    QHash<QString,QStringList> getOpenedContents(const QStringList& files);
 private:
     TodoThread* mThread;
+    PTodoCache mCache;
     QRecursiveMutex mMutex;
 };
 
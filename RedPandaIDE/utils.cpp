@@ -375,7 +375,8 @@ ProcessOutput runAndGetOutput(const QString &cmd, const QString& workingDir, con
                            const QByteArray &inputContent,
                            bool separateStderr,
                            bool inheritEnvironment,
-                           const QProcessEnvironment& env)
+                           const QProcessEnvironment& env,
+                           int timeout)
 {
     QProcess process;
     QByteArray standardOutput;
@@ -415,7 +416,10 @@ ProcessOutput runAndGetOutput(const QString &cmd, const QString& workingDir, con
         process.write(inputContent);
     }
     process.closeWriteChannel();
-    process.waitForFinished();
+    if (!process.waitForFinished(timeout) && process.state()!=QProcess::NotRunning) {
+        process.kill();
+        process.waitForFinished();
+    }
     if (errorOccurred) {
         switch(process.error()) {
         case QProcess::FailedToStart:
@@ -439,7 +443,10 @@ ProcessOutput runAndGetOutput(const QString &cmd, const QString& workingDir, con
         }
         errorMessage += process.errorString();
     }
-    return {standardOutput, standardError, errorMessage};
+    int exitCode = -1;
+    if (!errorOccurred && process.exitStatus() == QProcess::NormalExit)
+        exitCode = process.exitCode();
+    return {standardOutput, standardError, errorMessage, exitCode};
 }
 
 void executeFile(const QString &fileName, const QStringList &params, const QString &workingDir, const QString &tempFile)
@@ -671,6 +678,46 @@ QString osArch()
 #endif
 }
 
+int physicalCoreCount()
+{
+    int count = 0;
+#ifdef Q_OS_WINDOWS
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    if (length > 0) {
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (GetLogicalProcessorInformation(infos.data(), &length)) {
+            for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info : infos) {
+                if (info.Relationship == RelationProcessorCore)
+                    count++;
+            }
+        }
+    }
+#elif defined(Q_OS_LINUX)
+    // count distinct (physical id, core id) pairs, so hyper-threads are not counted
+    QFile file("/proc/cpuinfo");
+    if (file.open(QFile::ReadOnly)) {
+        QSet<QByteArray> cores;
+        QByteArray physicalId;
+        foreach (const QByteArray& line, file.readAll().split('\n')) {
+            int pos = line.indexOf(':');
+            if (pos < 0)
+                continue;
+            QByteArray key = line.left(pos).trimmed();
+            QByteArray value = line.mid(pos + 1).trimmed();
+            if (key == "physical id")
+                physicalId = value;
+            else if (key == "core id")
+                cores.insert(physicalId + ":" + value);
+        }
+        count = cores.count();
+    }
+#endif
+    if (count <= 0)
+        count = QThread::idealThreadCount();
+    return count;
+}
+
 QString byteArrayToString(const QByteArray &content, bool isUTF8)
 {
     if (isUTF8)
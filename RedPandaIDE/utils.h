@@ -148,13 +148,16 @@ struct ProcessOutput
     QByteArray standardOutput;
     QByteArray standardError;
     QString errorMessage;
+    //-1 if the process didn't exit normally
+    int exitCode;
 };
 
 ProcessOutput runAndGetOutput(const QString& cmd, const QString& workingDir, const QStringList& arguments,
                            const QByteArray& inputContent = QByteArray(),
                            bool separateStderr = false,
                            bool inheritEnvironment = false,
-                           const QProcessEnvironment& env = QProcessEnvironment() );
+                           const QProcessEnvironment& env = QProcessEnvironment(),
+                           int timeout = 30000);
 
 void openFileFolderInExplorer(const QString& path);
 
@@ -198,6 +201,7 @@ QStringList platformCommandForTerminalArgsPreview();
 
 QString appArch();
 QString osArch();
+int physicalCoreCount();
 
 QString byteArrayToString(const QByteArray &content, bool isUTF8);
 QByteArray stringToByteArray(const QString& content, bool isUTF8);
@@ -25,6 +25,54 @@
 #include "../utils.h"
 #include "../iconsmanager.h"
 
+struct ClassBrowserTree {
+    PCppParser parser;
+    ProjectClassBrowserType classBrowserType;
+    QString currentFile;
+    bool showInherited;
+    bool hideSymbolsStartsWithUnderLine;
+    bool hideSymbolsStartsWithTwoUnderLine;
+    bool sortAlpha;
+    bool sortType;
+
+    ClassBrowserNode* root;
+    QHash<ClassBrowserNode*,PClassBrowserNode> nodes;
+    QHash<QString,PStatement> dummyStatements;
+    QHash<QString,ClassBrowserNode*> scopeNodes;
+    QSet<Statement*> processedStatements;
+
+    ClassBrowserTree();
+    ~ClassBrowserTree();
+    void addMembers();
+    void sort();
+private:
+    ClassBrowserNode* addChild(ClassBrowserNode* node, const PStatement& statement);
+    void sortNode(ClassBrowserNode * node);
+    void filterChildren(ClassBrowserNode * node, const StatementMap& statements);
+    PStatement createDummy(const PStatement& statement);
+    ClassBrowserNode* getParentNode(const PStatement &parentStatement, int depth);
+    static bool isScopeStatement(const PStatement& statement);
+};
+
+ClassBrowserNodeKey ClassBrowserNodeKey::fromStatement(const PStatement &statement)
+{
+    ClassBrowserNodeKey key;
+    key.fullName = statement->fullName;
+    key.noNameArgs = statement->noNameArgs;
+    key.kind = statement->kind;
+    return key;
+}
+
+static bool sameDisplay(const PStatement& statement1, const PStatement& statement2)
+{
+    return statement1->kind == statement2->kind
+            && statement1->accessibility == statement2->accessibility
+            && statement1->command == statement2->command
+            && statement1->args == statement2->args
+            && statement1->type == statement2->type
+            && statement1->value == statement2->value;
+}
+
 ClassBrowserModel::ClassBrowserModel(QObject *parent):QAbstractItemModel(parent),
     mMutex()
 {
@@ -32,13 +80,19 @@ ClassBrowserModel::ClassBrowserModel(QObject *parent):QAbstractItemModel(parent)
     mRoot = new ClassBrowserNode();
     mRoot->parent = nullptr;
     mRoot->statement = PStatement();
-//    mRoot->childrenFetched = true;
+    mRoot->childrenFetched = true;
+    mBuildThread = nullptr;
+    mRefreshPending = false;
     mUpdating = false;
     mUpdateCount = 0;
 }
 
 ClassBrowserModel::~ClassBrowserModel()
 {
+    if (mBuildThread) {
+        mBuildThread->wait();
+        delete mBuildThread;
+    }
     delete mRoot;
 }
 
@@ -78,11 +132,7 @@ bool ClassBrowserModel::hasChildren(const QModelIndex &parent) const
         return mRoot->children.count()>0;
     } else {
         parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
-//        if (parentNode->childrenFetched)
         return parentNode->children.count()>0;
-//        if (parentNode->statement)
-//            return !parentNode->statement->children.isEmpty();
-//        return false;
     }
 }
 
@@ -94,6 +144,8 @@ int ClassBrowserModel::rowCount(const QModelIndex &parent) const
     } else {
         parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
     }
+    if (!parentNode->childrenFetched)
+        return 0;
     return parentNode->children.count();
 }
 
@@ -102,37 +154,32 @@ int ClassBrowserModel::columnCount(const QModelIndex&) const
     return 1;
 }
 
-//void ClassBrowserModel::fetchMore(const QModelIndex &parent)
-//{
-//    if (!parent.isValid()) { // top level
-//        return;
-//    }
+void ClassBrowserModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid()) { // top level
+        return;
+    }
 
-//    ClassBrowserNode *parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
-//    if (!parentNode->childrenFetched) {
-//        parentNode->childrenFetched = true;
-//        if (parentNode->statement && !parentNode->statement->children.isEmpty()) {
-//            filterChildren(parentNode, parentNode->statement->children);
-//            beginInsertRows(parent,0,parentNode->children.count());
-//            endInsertRows();
-//        }
-//    }
-//}
+    ClassBrowserNode *parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
+    if (parentNode->childrenFetched)
+        return;
+    if (parentNode->children.isEmpty()) {
+        parentNode->childrenFetched = true;
+        return;
+    }
+    beginInsertRows(parent,0,parentNode->children.count()-1);
+    parentNode->childrenFetched = true;
+    endInsertRows();
+}
 
-//bool ClassBrowserModel::canFetchMore(const QModelIndex &parent) const
-//{
-//    if (!parent.isValid()) { // top level
-//        return false;
-//    }
-//    ClassBrowserNode *parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
-//    if (!parentNode->childrenFetched) {
-//        if (parentNode->statement && !parentNode->statement->children.isEmpty())
-//            return true;
-//        else
-//            parentNode->childrenFetched = true;
-//    }
-//    return false;
-//}
+bool ClassBrowserModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) { // top level
+        return false;
+    }
+    ClassBrowserNode *parentNode = static_cast<ClassBrowserNode *>(parent.internalPointer());
+    return !parentNode->childrenFetched && !parentNode->children.isEmpty();
+}
 
 QVariant ClassBrowserModel::data(const QModelIndex &index, int role) const
 {
@@ -214,9 +261,6 @@ void ClassBrowserModel::clear()
     mRoot->children.clear();
     mNodes.clear();
     mNodeIndex.clear();
-    mProcessedStatements.clear();
-    mDummyStatements.clear();
-    mScopeNodes.clear();
     endResetModel();
 }
 
@@ -224,82 +268,248 @@ void ClassBrowserModel::fillStatements()
 {
     {
         QMutexLocker locker(&mMutex);
-        if (mUpdateCount!=0 || mUpdating)
+        if (mUpdateCount!=0)
+            return;
+        if (mUpdating) {
+            //refill when the running build is finished
+            mRefreshPending = true;
             return;
+        }
+    }
+    if (!mParser || !mParser->enabled()) {
+        clear();
+        return;
+    }
+    //keep the current tree until the parser is available
+    if (!mParser->freeze())
+        return;
+    {
+        QMutexLocker locker(&mMutex);
         mUpdating = true;
+        mRefreshPending = false;
     }
     emit refreshStarted();
-    beginResetModel();
-    clear();
+    PClassBrowserTree tree = std::make_shared<ClassBrowserTree>();
+    tree->parser = mParser;
+    tree->classBrowserType = mClassBrowserType;
+    tree->currentFile = mCurrentFile;
+    tree->showInherited = pSettings->ui().classBrowserShowInherited();
+    tree->hideSymbolsStartsWithUnderLine = pSettings->codeCompletion().hideSymbolsStartsWithUnderLine();
+    tree->hideSymbolsStartsWithTwoUnderLine = pSettings->codeCompletion().hideSymbolsStartsWithTwoUnderLine();
+    tree->sortAlpha = pSettings->ui().classBrowserSortAlpha();
+    tree->sortType = pSettings->ui().classBrowserSortType();
+    mNewTree = tree;
+    //the nodes keep the statements alive, so the parser is only frozen while collecting them
+    tree->addMembers();
+    mParser->unFreeze();
+    // sort the new tree in background, then merge it into the model
+    mBuildThread = QThread::create([tree]{
+        tree->sort();
+    });
+    connect(mBuildThread, &QThread::finished,
+            this, &ClassBrowserModel::onTreeBuilt);
+    mBuildThread->start();
+}
+
+void ClassBrowserModel::onTreeBuilt()
+{
+    mBuildThread->deleteLater();
+    mBuildThread = nullptr;
+    if (mNewTree->parser == mParser
+            && mNewTree->currentFile == mCurrentFile
+            && mNewTree->classBrowserType == mClassBrowserType) {
+        mergeChildren(mRoot, QModelIndex(), mNewTree->root);
+    } else {
+        //settings changed while building
+        mRefreshPending = true;
+    }
+    mNewTree.reset();
     {
-        auto action = finally([this]{
-            endResetModel();
-            mUpdating = false;
-            emit refreshEnd();
-        });
-        if (!mParser)
-            return;
-        if (!mParser->enabled())
-            return;
-        if (!mParser->freeze())
-            return;
-        QString mParserSerialId = mParser->serialId();
-        addMembers();
-        mParser->unFreeze();
+        QMutexLocker locker(&mMutex);
+        mUpdating = false;
+    }
+    emit refreshEnd();
+    if (mRefreshPending) {
+        mRefreshPending = false;
+        fillStatements();
     }
 }
 
-PClassBrowserNode ClassBrowserModel::addChild(ClassBrowserNode *node, const PStatement& statement)
+void ClassBrowserModel::mergeChildren(ClassBrowserNode *node, const QModelIndex &nodeIndex, ClassBrowserNode *newNode)
+{
+    QHash<ClassBrowserNodeKey,int> newKeys;
+    foreach (ClassBrowserNode* child, newNode->children) {
+        newKeys[ClassBrowserNodeKey::fromStatement(child->statement)]++;
+    }
+    //remove rows that are not in the new tree
+    QVector<bool> keep(node->children.count());
+    QHash<ClassBrowserNodeKey,int> remainingKeys;
+    for (int i=0;i<node->children.count();i++) {
+        ClassBrowserNodeKey key = ClassBrowserNodeKey::fromStatement(node->children[i]->statement);
+        int &count = newKeys[key];
+        keep[i] = (count>0);
+        if (keep[i]) {
+            count--;
+            remainingKeys[key]++;
+        }
+    }
+    for (int last=node->children.count()-1;last>=0;last--) {
+        if (keep[last])
+            continue;
+        int first=last;
+        while (first>0 && !keep[first-1])
+            first--;
+        beginRemoveRows(nodeIndex,first,last);
+        QVector<ClassBrowserNode*> removed = node->children.mid(first,last-first+1);
+        node->children.remove(first,last-first+1);
+        foreach (ClassBrowserNode* child, removed)
+            releaseNode(child);
+        endRemoveRows();
+        last=first;
+    }
+    //move kept rows to their new positions, and insert new rows
+    for (int i=0;i<newNode->children.count();i++) {
+        ClassBrowserNode* newChild = newNode->children[i];
+        ClassBrowserNodeKey key = ClassBrowserNodeKey::fromStatement(newChild->statement);
+        if (remainingKeys.value(key,0)>0) {
+            int j=i;
+            while (!(ClassBrowserNodeKey::fromStatement(node->children[j]->statement) == key))
+                j++;
+            if (j!=i) {
+                beginMoveRows(nodeIndex,j,j,nodeIndex,i);
+                node->children.move(j,i);
+                endMoveRows();
+            }
+            remainingKeys[key]--;
+            updateNode(node->children[i], index(i,0,nodeIndex), newChild);
+        } else {
+            int last=i;
+            while (last+1<newNode->children.count()
+                   && remainingKeys.value(
+                       ClassBrowserNodeKey::fromStatement(newNode->children[last+1]->statement),0)==0)
+                last++;
+            beginInsertRows(nodeIndex,i,last);
+            for (int k=i;k<=last;k++) {
+                adoptNode(node,newNode->children[k]);
+                node->children.insert(k,newNode->children[k]);
+            }
+            endInsertRows();
+            i=last;
+        }
+    }
+}
+
+void ClassBrowserModel::updateNode(ClassBrowserNode *node, const QModelIndex &nodeIndex, ClassBrowserNode *newNode)
+{
+    bool changed = !sameDisplay(node->statement, newNode->statement);
+    node->statement = newNode->statement;
+    if (node->childrenFetched) {
+        mergeChildren(node, nodeIndex, newNode);
+    } else {
+        //children are not shown yet, just replace them
+        bool hadChildren = !node->children.isEmpty();
+        foreach (ClassBrowserNode* child, node->children)
+            releaseNode(child);
+        node->children.clear();
+        adoptChildren(node, newNode);
+        if (hadChildren != !node->children.isEmpty())
+            changed = true;
+    }
+    if (changed)
+        emit dataChanged(nodeIndex,nodeIndex);
+}
+
+void ClassBrowserModel::adoptChildren(ClassBrowserNode *node, ClassBrowserNode *newNode)
+{
+    foreach (ClassBrowserNode* child, newNode->children) {
+        adoptNode(node, child);
+        node->children.append(child);
+    }
+}
+
+void ClassBrowserModel::adoptNode(ClassBrowserNode *parent, ClassBrowserNode *newNode)
+{
+    newNode->parent = parent;
+    mNodes.insert(newNode, mNewTree->nodes.value(newNode));
+    mNodeIndex.insert(ClassBrowserNodeKey::fromStatement(newNode->statement), newNode);
+    foreach (ClassBrowserNode* child, newNode->children)
+        adoptNode(newNode, child);
+}
+
+void ClassBrowserModel::releaseNode(ClassBrowserNode *node)
+{
+    foreach (ClassBrowserNode* child, node->children)
+        releaseNode(child);
+    ClassBrowserNodeKey key = ClassBrowserNodeKey::fromStatement(node->statement);
+    if (mNodeIndex.value(key,nullptr) == node)
+        mNodeIndex.remove(key);
+    //node is freed here
+    mNodes.remove(node);
+}
+
+ClassBrowserTree::ClassBrowserTree()
+{
+    root = new ClassBrowserNode();
+    root->parent = nullptr;
+    root->statement = PStatement();
+    root->childrenFetched = true;
+}
+
+ClassBrowserTree::~ClassBrowserTree()
+{
+    delete root;
+}
+
+void ClassBrowserTree::sort()
+{
+    sortNode(root);
+}
+
+ClassBrowserNode* ClassBrowserTree::addChild(ClassBrowserNode *node, const PStatement& statement)
 {
     PClassBrowserNode newNode = std::make_shared<ClassBrowserNode>();
     newNode->parent = node;
     newNode->statement = statement;
-//    newNode->childrenFetched = false;
+    newNode->childrenFetched = false;
     node->children.append(newNode.get());
-    mNodes.append(newNode);
-    mNodeIndex.insert(
-                QString("%1+%2+%3")
-                .arg(statement->fullName)
-                .arg(statement->noNameArgs)
-                .arg((int)statement->kind),newNode);
-    mProcessedStatements.insert(statement.get());
+    nodes.insert(newNode.get(), newNode);
+    processedStatements.insert(statement.get());
     if (isScopeStatement(statement)) {
-        mScopeNodes.insert(statement->fullName,newNode);
+        scopeNodes.insert(statement->fullName,newNode.get());
     }
     //don't show enum type's children values (they are displayed in parent scope)
 //    if (statement->kind != StatementKind::skEnumType) {
         filterChildren(newNode.get(), statement->children);
 //    }
-    return newNode;
+    return newNode.get();
 }
 
-void ClassBrowserModel::addMembers()
+void ClassBrowserTree::addMembers()
 {
-    if (mClassBrowserType==ProjectClassBrowserType::CurrentFile) {
-        if (mCurrentFile.isEmpty())
+    if (classBrowserType==ProjectClassBrowserType::CurrentFile) {
+        if (currentFile.isEmpty())
             return;
         // show statements in the file
-        PParsedFileInfo p = mParser->findFileInfo(mCurrentFile);
+        PParsedFileInfo p = parser->findFileInfo(currentFile);
         if (!p)
             return;
-        filterChildren(mRoot,p->statements());
+        filterChildren(root,p->statements());
     } else {
-        if (mParser->projectFiles().isEmpty())
+        if (parser->projectFiles().isEmpty())
             return;
-        foreach(const QString& file,mParser->projectFiles()) {
-            PParsedFileInfo p = mParser->findFileInfo(file);
+        foreach(const QString& file,parser->projectFiles()) {
+            PParsedFileInfo p = parser->findFileInfo(file);
             if (!p)
                 return;
-            filterChildren(mRoot,p->statements());
+            filterChildren(root,p->statements());
         }
     }
-    sortNode(mRoot);
 }
 
-void ClassBrowserModel::sortNode(ClassBrowserNode *node)
+void ClassBrowserTree::sortNode(ClassBrowserNode *node)
 {
-    if (!pSettings->ui().classBrowserSortAlpha()) {
-        if (mClassBrowserType==ProjectClassBrowserType::CurrentFile) {
+    if (!sortAlpha) {
+        if (classBrowserType==ProjectClassBrowserType::CurrentFile) {
             std::sort(node->children.begin(),node->children.end(),
                       [](ClassBrowserNode* node1,ClassBrowserNode* node2) {
                 return (node1->statement->line < node2->statement->line);
@@ -317,8 +527,7 @@ void ClassBrowserModel::sortNode(ClassBrowserNode *node)
         };
     }
 
-    if (pSettings->ui().classBrowserSortAlpha()
-            && pSettings->ui().classBrowserSortType()) {
+    if (sortAlpha && sortType) {
         std::sort(node->children.begin(),node->children.end(),
                   [](ClassBrowserNode* node1,ClassBrowserNode* node2) {
             if (node1->statement->kind < node2->statement->kind) {
@@ -329,12 +538,12 @@ void ClassBrowserModel::sortNode(ClassBrowserNode *node)
                 return false;
             }
         });
-    } else if (pSettings->ui().classBrowserSortAlpha()) {
+    } else if (sortAlpha) {
         std::sort(node->children.begin(),node->children.end(),
                   [](ClassBrowserNode* node1,ClassBrowserNode* node2) {
             return node1->statement->command.toLower() < node2->statement->command.toLower();
         });
-    } else if (pSettings->ui().classBrowserSortType()) {
+    } else if (sortType) {
         std::sort(node->children.begin(),node->children.end(),
                   [](ClassBrowserNode* node1,ClassBrowserNode* node2) {
             return node1->statement->kind < node2->statement->kind;
@@ -345,14 +554,14 @@ void ClassBrowserModel::sortNode(ClassBrowserNode *node)
     }
 }
 
-void ClassBrowserModel::filterChildren(ClassBrowserNode *node, const StatementMap &statements)
+void ClassBrowserTree::filterChildren(ClassBrowserNode *node, const StatementMap &statements)
 {
     for (PStatement statement:statements) {
-        if (mClassBrowserType==ProjectClassBrowserType::WholeProject
+        if (classBrowserType==ProjectClassBrowserType::WholeProject
                 && !statement->inProject())
             continue;
 
-        if (mProcessedStatements.contains(statement.get()))
+        if (processedStatements.contains(statement.get()))
             continue;
 //        if (statement->properties.testFlag(StatementProperty::spDummyStatement))
 //            continue;
@@ -361,7 +570,7 @@ void ClassBrowserModel::filterChildren(ClassBrowserNode *node, const StatementMa
             continue;
         if (statement->kind == StatementKind::Lambda)
             continue;
-        if (statement->isInherited() && !pSettings->ui().classBrowserShowInherited())
+        if (statement->isInherited() && !showInherited)
             continue;
 
         if (statement == node->statement) // prevent infinite recursion
@@ -370,11 +579,11 @@ void ClassBrowserModel::filterChildren(ClassBrowserNode *node, const StatementMa
         if (statement->scope == StatementScope::Local)
             continue;
 
-        if (pSettings->codeCompletion().hideSymbolsStartsWithTwoUnderLine()
+        if (hideSymbolsStartsWithTwoUnderLine
                 && statement->command.startsWith("__"))
             continue;
 
-        if (pSettings->codeCompletion().hideSymbolsStartsWithUnderLine()
+        if (hideSymbolsStartsWithUnderLine
                 && statement->command.startsWith('_'))
             continue;
 
@@ -399,20 +608,19 @@ void ClassBrowserModel::filterChildren(ClassBrowserNode *node, const StatementMa
                 parentNode = dummyNode;
         }
         if (isScopeStatement(statement)) {
-            //PStatement dummy = mDummyStatements.value(statement->fullName,PStatement());
-            PClassBrowserNode scopeNode = mScopeNodes.value(statement->fullName,PClassBrowserNode());
+            ClassBrowserNode* scopeNode = scopeNodes.value(statement->fullName,nullptr);
             if (!scopeNode) {
                 PStatement dummy = createDummy(statement);
                 scopeNode = addChild(parentNode,dummy);
             }
-            filterChildren(scopeNode.get(),statement->children);
+            filterChildren(scopeNode,statement->children);
         } else {
             addChild(parentNode,statement);
         }
     }
 }
 
-PStatement ClassBrowserModel::createDummy(const PStatement& statement)
+PStatement ClassBrowserTree::createDummy(const PStatement& statement)
 {
     PStatement result = std::make_shared<Statement>();
     result->parentScope = statement->parentScope;
@@ -430,27 +638,27 @@ PStatement ClassBrowserModel::createDummy(const PStatement& statement)
     result->line = statement->line;
     result->definitionFileName = statement->fileName;
     result->definitionLine = statement->definitionLine;
-    mDummyStatements.insert(result->fullName,result);
+    dummyStatements.insert(result->fullName,result);
     return result;
 }
 
-ClassBrowserNode* ClassBrowserModel::getParentNode(const PStatement &parentStatement, int depth)
+ClassBrowserNode* ClassBrowserTree::getParentNode(const PStatement &parentStatement, int depth)
 {
     Q_ASSERT(depth<=10);
-    if (depth>10) return mRoot;
-    if (!parentStatement) return mRoot;
-    if (!isScopeStatement(parentStatement)) return mRoot;
+    if (depth>10) return root;
+    if (!parentStatement) return root;
+    if (!isScopeStatement(parentStatement)) return root;
 
-    PClassBrowserNode parentNode = mScopeNodes.value(parentStatement->fullName,PClassBrowserNode());
+    ClassBrowserNode* parentNode = scopeNodes.value(parentStatement->fullName,nullptr);
     if (!parentNode) {
         PStatement dummyParent = createDummy(parentStatement);
         ClassBrowserNode *grandNode = getParentNode(parentStatement->parentScope.lock(), depth+1);
         parentNode = addChild(grandNode,dummyParent);
     }
-    return parentNode.get();
+    return parentNode;
 }
 
-bool ClassBrowserModel::isScopeStatement(const PStatement &statement)
+bool ClassBrowserTree::isScopeStatement(const PStatement &statement)
 {
     switch(statement->kind) {
     case StatementKind::Class:
@@ -463,22 +671,30 @@ bool ClassBrowserModel::isScopeStatement(const PStatement &statement)
     }
 }
 
-QModelIndex ClassBrowserModel::modelIndexForStatement(const QString &key) const
+QModelIndex ClassBrowserModel::modelIndexForStatement(const ClassBrowserNodeKey &key)
 {
-    QMutexLocker locker(&mMutex);
-    if (mUpdating)
-        return QModelIndex();
-    PClassBrowserNode node=mNodeIndex.value(key,PClassBrowserNode());
+    {
+        QMutexLocker locker(&mMutex);
+        if (mUpdating)
+            return QModelIndex();
+    }
+    ClassBrowserNode* node=mNodeIndex.value(key,nullptr);
     if (!node)
         return QModelIndex();
-
-    ClassBrowserNode *parentNode=node->parent;
-    if (!parentNode)
-        return QModelIndex();
-    int row=parentNode->children.indexOf(node.get());
-    if (row<0)
-        return QModelIndex();
-    return createIndex(row,0,node.get());
+    //fetch the ancestors, so the node is visible in the view
+    QVector<ClassBrowserNode*> path;
+    for (ClassBrowserNode* p=node; p && p!=mRoot; p=p->parent)
+        path.prepend(p);
+    QModelIndex index;
+    foreach (ClassBrowserNode* p, path) {
+        int row=p->parent->children.indexOf(p);
+        if (row<0)
+            return QModelIndex();
+        index = createIndex(row,0,p);
+        if (p!=node && !p->childrenFetched)
+            fetchMore(index);
+    }
+    return index;
 }
 
 ProjectClassBrowserType ClassBrowserModel::classBrowserType() const
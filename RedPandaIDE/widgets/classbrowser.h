@@ -18,6 +18,7 @@
 #define CLASSBROWSER_H
 
 #include <QAbstractItemModel>
+#include <QThread>
 #include "parser/cppparser.h"
 #include "../projectoptions.h"
 
@@ -25,11 +26,30 @@ struct ClassBrowserNode {
     ClassBrowserNode* parent;
     PStatement statement;
     QVector<ClassBrowserNode *> children;
-//    bool childrenFetched;
+    bool childrenFetched;
 };
 
 using PClassBrowserNode = std::shared_ptr<ClassBrowserNode>;
 
+struct ClassBrowserNodeKey {
+    QString fullName;
+    QString noNameArgs;
+    StatementKind kind = StatementKind::Unknown;
+    bool operator==(const ClassBrowserNodeKey& other) const {
+        return kind == other.kind
+                && fullName == other.fullName
+                && noNameArgs == other.noNameArgs;
+    }
+    static ClassBrowserNodeKey fromStatement(const PStatement& statement);
+};
+
+inline uint qHash(const ClassBrowserNodeKey& key, uint seed) {
+    return qHash(key.fullName, seed) ^ qHash(key.noNameArgs, seed) ^ qHash(key.kind, seed);
+}
+
+struct ClassBrowserTree;
+using PClassBrowserTree = std::shared_ptr<ClassBrowserTree>;
+
 class ColorSchemeItem;
 
 class ClassBrowserModel : public QAbstractItemModel{
@@ -45,8 +65,8 @@ public:
     bool hasChildren(const QModelIndex &parent) const override;
     int rowCount(const QModelIndex &parent) const override;
     int columnCount(const QModelIndex &parent) const override;
-//    void fetchMore(const QModelIndex &parent) override;
-//    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    bool canFetchMore(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     const PCppParser &parser() const;
     void setParser(const PCppParser &newCppParser);
@@ -62,27 +82,27 @@ public:
     ProjectClassBrowserType classBrowserType() const;
     void setClassBrowserType(ProjectClassBrowserType newClassBrowserType);
 
-    QModelIndex modelIndexForStatement(const QString& key) const;
+    QModelIndex modelIndexForStatement(const ClassBrowserNodeKey& key);
 signals:
     void refreshStarted();
     void refreshEnd();
 public slots:
     void fillStatements();
+private slots:
+    void onTreeBuilt();
 private:
-    PClassBrowserNode addChild(ClassBrowserNode* node, const PStatement& statement);
-    void addMembers();
-    void sortNode(ClassBrowserNode * node);
-    void filterChildren(ClassBrowserNode * node, const StatementMap& statements);
-    PStatement createDummy(const PStatement& statement);
-    ClassBrowserNode* getParentNode(const PStatement &parentStatement, int depth);
-    bool isScopeStatement(const PStatement& statement);
+    void mergeChildren(ClassBrowserNode* node, const QModelIndex& nodeIndex, ClassBrowserNode* newNode);
+    void updateNode(ClassBrowserNode* node, const QModelIndex& nodeIndex, ClassBrowserNode* newNode);
+    void adoptChildren(ClassBrowserNode* node, ClassBrowserNode* newNode);
+    void adoptNode(ClassBrowserNode* parent, ClassBrowserNode* newNode);
+    void releaseNode(ClassBrowserNode* node);
 private:
     ClassBrowserNode * mRoot;
-    QHash<QString,PStatement> mDummyStatements;
-    QHash<QString,PClassBrowserNode> mScopeNodes;
-    QHash<QString,PClassBrowserNode> mNodeIndex;
-    QSet<Statement*> mProcessedStatements;
-    QVector<PClassBrowserNode> mNodes;
+    QHash<ClassBrowserNodeKey,ClassBrowserNode*> mNodeIndex;
+    QHash<ClassBrowserNode*,PClassBrowserNode> mNodes;
+    PClassBrowserTree mNewTree;
+    QThread* mBuildThread;
+    bool mRefreshPending;
     PCppParser mParser;
     bool mUpdating;
     int mUpdateCount;
@@ -36,6 +36,7 @@ HeaderCompletionPopup::HeaderCompletionPopup(QWidget* parent):QWidget(parent)
     mListView->setModel(mModel);
     delete m;
     mDelegate = new HeaderCompletionListItemDelegate(mModel,this);
+    mDirIndex = new HeaderDirIndex(this);
     mListView->setItemDelegate(mDelegate);
     setLayout(new QVBoxLayout());
     layout()->addWidget(mListView);
@@ -236,38 +237,22 @@ void HeaderCompletionPopup::getCompletionFor(const QString &phrase)
 void HeaderCompletionPopup::addFilesInPath(const QString &path, HeaderCompletionListItemType type)
 {
     QDir dir(path);
-    if (!dir.exists())
-        return;
-    foreach (const QFileInfo& fileInfo, dir.entryInfoList()) {
-        if (fileInfo.fileName().startsWith("."))
-            continue;
-        if (fileInfo.isDir()) {
-            addFile(dir, fileInfo, type);
-            continue;
-        }
-        QString suffix = fileInfo.suffix().toLower();
-        if (suffix == "h" || suffix == "hpp" || suffix == "") {
-            addFile(dir, fileInfo, type);
-        }
+    foreach (const HeaderDirEntry& entry, mDirIndex->entries(cleanPath(dir.absolutePath()))) {
+        addFile(dir, entry, type);
     }
 }
 
-void HeaderCompletionPopup::addFile(const QDir& dir, const QFileInfo& fileInfo, HeaderCompletionListItemType type)
+void HeaderCompletionPopup::addFile(const QDir& dir, const HeaderDirEntry& entry, HeaderCompletionListItemType type)
 {
-    QString fileName = fileInfo.fileName();
-    if (fileName.isEmpty())
-        return;
-    if (fileName.startsWith('.'))
-        return;
     PHeaderCompletionListItem item = std::make_shared<HeaderCompletionListItem>();
-    item->filename = fileName;
-    item->noSuffixFilename = fileInfo.baseName();
-    item->suffix = fileInfo.suffix();
+    item->filename = entry.fileName;
+    item->noSuffixFilename = entry.baseName;
+    item->suffix = entry.suffix;
     item->itemType = type;
-    item->fullpath = cleanPath(dir.absoluteFilePath(fileName));
+    item->fullpath = cleanPath(dir.absoluteFilePath(entry.fileName));
     item->usageCount = mHeaderUsageCounts.value(item->fullpath,0);
-    item->isFolder = fileInfo.isDir();
-    mFullCompletionList.insert(fileName,item);
+    item->isFolder = entry.isFolder;
+    mFullCompletionList.insert(entry.fileName,item);
 }
 
 void HeaderCompletionPopup::addFilesInSubDir(const QString &baseDirPath, const QString &subDirName, HeaderCompletionListItemType type)
@@ -307,6 +292,18 @@ void HeaderCompletionPopup::setParser(const PCppParser &newParser)
     mParser = newParser;
 }
 
+void HeaderCompletionPopup::prepareIndex(const PCppParser &parser)
+{
+    if (!parser)
+        return;
+    QStringList dirs;
+    foreach (const QString& path, parser->includePaths())
+        dirs.append(cleanPath(QDir(path).absolutePath()));
+    foreach (const QString& path, parser->projectIncludePaths())
+        dirs.append(cleanPath(QDir(path).absolutePath()));
+    mDirIndex->prepare(dirs);
+}
+
 void HeaderCompletionPopup::hideEvent(QHideEvent *)
 {
     mCompletionList.clear();
@@ -329,6 +326,114 @@ bool HeaderCompletionPopup::event(QEvent *event)
     return result;
 }
 
+HeaderDirIndex::HeaderDirIndex(QObject *parent):
+    QObject{parent},
+    mThread{nullptr}
+{
+    connect(&mWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &HeaderDirIndex::onDirectoryChanged);
+}
+
+HeaderDirIndex::~HeaderDirIndex()
+{
+    if (mThread) {
+        mThread->wait();
+        delete mThread;
+    }
+}
+
+QList<HeaderDirEntry> HeaderDirIndex::entries(const QString &dirPath)
+{
+    {
+        QMutexLocker locker(&mMutex);
+        auto it = mDirs.constFind(dirPath);
+        if (it != mDirs.constEnd())
+            return it.value();
+    }
+    QList<HeaderDirEntry> result = listDir(dirPath);
+    {
+        QMutexLocker locker(&mMutex);
+        mDirs.insert(dirPath, result);
+    }
+    watch(dirPath);
+    return result;
+}
+
+void HeaderDirIndex::prepare(const QStringList &dirPaths)
+{
+    if (mThread)
+        return;
+    QStringList dirs;
+    {
+        QMutexLocker locker(&mMutex);
+        foreach (const QString& dirPath, dirPaths) {
+            if (!mDirs.contains(dirPath))
+                dirs.append(dirPath);
+        }
+    }
+    if (dirs.isEmpty())
+        return;
+    mThread = QThread::create([this,dirs]{
+        foreach (const QString& dirPath, dirs) {
+            QList<HeaderDirEntry> result = listDir(dirPath);
+            QMutexLocker locker(&mMutex);
+            mDirs.insert(dirPath, result);
+        }
+    });
+    mPreparedDirs = dirs;
+    connect(mThread, &QThread::finished,
+            this, &HeaderDirIndex::onPrepareFinished);
+    mThread->start();
+}
+
+void HeaderDirIndex::onDirectoryChanged(const QString &path)
+{
+    //relisted on next lookup
+    QMutexLocker locker(&mMutex);
+    mDirs.remove(path);
+}
+
+void HeaderDirIndex::onPrepareFinished()
+{
+    //the watcher can only be used in its own thread
+    foreach (const QString& dirPath, mPreparedDirs)
+        watch(dirPath);
+    mPreparedDirs.clear();
+    mThread->deleteLater();
+    mThread = nullptr;
+}
+
+QList<HeaderDirEntry> HeaderDirIndex::listDir(const QString &dirPath)
+{
+    QList<HeaderDirEntry> result;
+    QDir dir(dirPath);
+    if (!dir.exists())
+        return result;
+    foreach (const QFileInfo& fileInfo, dir.entryInfoList()) {
+        QString fileName = fileInfo.fileName();
+        if (fileName.isEmpty() || fileName.startsWith('.'))
+            continue;
+        HeaderDirEntry entry;
+        entry.isFolder = fileInfo.isDir();
+        if (!entry.isFolder) {
+            QString suffix = fileInfo.suffix().toLower();
+            if (suffix != "h" && suffix != "hpp" && suffix != "")
+                continue;
+        }
+        entry.fileName = fileName;
+        entry.baseName = fileInfo.baseName();
+        entry.suffix = fileInfo.suffix();
+        result.append(entry);
+    }
+    return result;
+}
+
+void HeaderDirIndex::watch(const QString &dirPath)
+{
+    if (!mWatcher.directories().contains(dirPath) && QDir(dirPath).exists())
+        mWatcher.addPath(dirPath);
+}
+
 HeaderCompletionListModel::HeaderCompletionListModel(const QList<PHeaderCompletionListItem> *files, int matched, QObject *parent):
     QAbstractListModel{parent},
     mFiles{files},
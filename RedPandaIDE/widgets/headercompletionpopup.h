@@ -18,7 +18,10 @@
 #define HEADERCOMPLETIONPOPUP_H
 
 #include <QDir>
+#include <QFileSystemWatcher>
+#include <QMutex>
 #include <QStyledItemDelegate>
+#include <QThread>
 #include <QWidget>
 #include "codecompletionlistview.h"
 #include "../parser/cppparser.h"
@@ -41,6 +44,39 @@ struct HeaderCompletionListItem {
 
 using PHeaderCompletionListItem=std::shared_ptr<HeaderCompletionListItem>;
 
+struct HeaderDirEntry {
+    QString fileName;
+    QString baseName;
+    QString suffix;
+    bool isFolder;
+};
+
+/**
+ * @brief In-memory listing of include directories.
+ * Include paths are listed in a background thread, and kept up to date
+ * by a file system watcher. Subdirectories are listed on first lookup.
+ */
+class HeaderDirIndex: public QObject {
+    Q_OBJECT
+public:
+    explicit HeaderDirIndex(QObject *parent = nullptr);
+    ~HeaderDirIndex();
+    QList<HeaderDirEntry> entries(const QString& dirPath);
+    void prepare(const QStringList& dirPaths);
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onPrepareFinished();
+private:
+    static QList<HeaderDirEntry> listDir(const QString& dirPath);
+    void watch(const QString& dirPath);
+private:
+    QHash<QString, QList<HeaderDirEntry>> mDirs;
+    QStringList mPreparedDirs;
+    QMutex mMutex;
+    QFileSystemWatcher mWatcher;
+    QThread* mThread;
+};
+
 class HeaderCompletionListModel: public QAbstractListModel {
     Q_OBJECT
 public:
@@ -117,7 +153,7 @@ private:
     void filterList(const QString& member);
     void getCompletionFor(const QString& phrase);
     void addFilesInPath(const QString& path, HeaderCompletionListItemType type);
-    void addFile(const QDir& dir,  const QFileInfo &fileInfo, HeaderCompletionListItemType type);
+    void addFile(const QDir& dir,  const HeaderDirEntry &entry, HeaderCompletionListItemType type);
     void addFilesInSubDir(const QString& baseDirPath, const QString& subDirName, HeaderCompletionListItemType type);
 private:
 
@@ -136,6 +172,7 @@ private:
     QString mCurrentFile;
 
     HeaderCompletionListItemDelegate* mDelegate;
+    HeaderDirIndex* mDirIndex;
 
     // QWidget interface
 protected:
@@ -145,6 +182,7 @@ protected:
 public:
     bool event(QEvent *event) override;
     void setParser(const PCppParser &newParser);
+    void prepareIndex(const PCppParser &parser);
     const QString &phrase() const;
     bool ignoreCase() const;
     void setIgnoreCase(bool newIgnoreCase);
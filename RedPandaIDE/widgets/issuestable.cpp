@@ -94,10 +94,12 @@ IssuesModel::IssuesModel(QObject *parent):
 
 }
 
-void IssuesModel::addIssue(PCompileIssue issue)
+void IssuesModel::addIssues(const QList<PCompileIssue> &issues)
 {
-    beginInsertRows(QModelIndex(),mIssues.size(),mIssues.size());
-    mIssues.push_back(issue);
+    if (issues.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(),mIssues.size(),mIssues.size()+issues.size()-1);
+    mIssues.append(issues.toVector());
     endInsertRows();
 }
 
@@ -121,6 +123,33 @@ void IssuesModel::clearIssues()
     }
 }
 
+QSet<QString> IssuesModel::removeIssues(const QList<PCompileIssue> &issues)
+{
+    QSet<QString> issueFiles;
+    if (issues.isEmpty())
+        return issueFiles;
+    QSet<CompileIssue*> toRemove;
+    foreach(const PCompileIssue& issue, issues) {
+        toRemove.insert(issue.get());
+    }
+    for (int i=mIssues.size()-1;i>=0;i--) {
+        if (!toRemove.contains(mIssues[i].get()))
+            continue;
+        if (!mIssues[i]->filename.isEmpty())
+            issueFiles.insert(mIssues[i]->filename);
+        beginRemoveRows(QModelIndex(),i,i);
+        mIssues.removeAt(i);
+        endRemoveRows();
+    }
+    //markers of the remaining issues must be added back by the caller
+    foreach (const QString& filename, issueFiles) {
+        Editor *e=pMainWindow->editorList()->getOpenedEditorByFilename(filename);
+        if (e)
+            e->clearSyntaxIssues();
+    }
+    return issueFiles;
+}
+
 void IssuesModel::setErrorColor(QColor color)
 {
     mErrorColor = color;
@@ -150,9 +179,9 @@ int IssuesModel::count()
     return mIssues.size();
 }
 
-void IssuesTable::addIssue(PCompileIssue issue)
+void IssuesTable::addIssues(const QList<PCompileIssue> &issues)
 {
-    mModel->addIssue(issue);
+    mModel->addIssues(issues);
 }
 
 PCompileIssue IssuesTable::issue(const QModelIndex &index)
@@ -177,6 +206,11 @@ void IssuesTable::clearIssues()
     mModel->clearIssues();
 }
 
+QSet<QString> IssuesTable::removeIssues(const QList<PCompileIssue> &issues)
+{
+    return mModel->removeIssues(issues);
+}
+
 int IssuesModel::rowCount(const QModelIndex &) const
 {
     return mIssues.size();
@@ -21,6 +21,7 @@
 #include <vector>
 #include "../common.h"
 #include <QAbstractTableModel>
+#include <QSet>
 
 class IssuesModel : public QAbstractTableModel {
 
@@ -29,8 +30,9 @@ public:
     explicit IssuesModel(QObject *parent = nullptr);
 
 public slots:
-    void addIssue(PCompileIssue issue);
+    void addIssues(const QList<PCompileIssue>& issues);
     void clearIssues();
+    QSet<QString> removeIssues(const QList<PCompileIssue>& issues);
 
     void setErrorColor(QColor color);
     void setWarningColor(QColor color);
@@ -67,13 +69,14 @@ public:
     QString toTxt();
 
 public slots:
-    void addIssue(PCompileIssue issue);
+    void addIssues(const QList<PCompileIssue>& issues);
 
     PCompileIssue issue(const QModelIndex& index);
     PCompileIssue issue(const int row);
     int count();
 
     void clearIssues();
+    QSet<QString> removeIssues(const QList<PCompileIssue>& issues);
 
 private:
     IssuesModel * mModel;
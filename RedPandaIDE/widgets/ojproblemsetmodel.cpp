@@ -16,6 +16,7 @@
  */
 #include "ojproblemsetmodel.h"
 
+#include <QColor>
 #include <QDir>
 #include <QFile>
 #include <QIcon>
@@ -136,6 +137,10 @@ void OJProblemSetModel::saveToFile(const QString &fileName, int currentIndex)
             problemObj["memory_limit_unit"]=(int)problem->memoryLimitUnit;
             if (fileExists(problem->answerProgram))
                 problemObj["answer_program"] = problem->answerProgram;
+            if (fileExists(problem->generatorProgram))
+                problemObj["generator_program"] = problem->generatorProgram;
+            if (fileExists(problem->bruteForceProgram))
+                problemObj["brute_force_program"] = problem->bruteForceProgram;
             QJsonArray cases;
             foreach (const POJProblemCase& problemCase, problem->cases) {
                 QJsonObject caseObj;
@@ -153,6 +158,15 @@ void OJProblemSetModel::saveToFile(const QString &fileName, int currentIndex)
                 }
                 caseObj["expected_output_filename"]=path;
                 caseObj["expected"]=problemCase->expected;
+                QJsonArray runHistory;
+                foreach (const OJProblemCaseRun& run, problemCase->runHistory) {
+                    QJsonObject runObj;
+                    runObj["time"]=(qint64)run.runningTime;
+                    runObj["memory"]=(qint64)run.runningMemory;
+                    runObj["timestamp"]=run.timestamp;
+                    runHistory.append(runObj);
+                }
+                caseObj["run_history"]=runHistory;
                 cases.append(caseObj);
             }
             problemObj["cases"]=cases;
@@ -202,6 +216,8 @@ void OJProblemSetModel::loadFromFile(const QString &fileName, int& currentIndex)
 
             problem->description = problemObj["description"].toString();
             problem->answerProgram = problemObj["answer_program"].toString();
+            problem->generatorProgram = problemObj["generator_program"].toString();
+            problem->bruteForceProgram = problemObj["brute_force_program"].toString();
             QJsonArray casesArray = problemObj["cases"].toArray();
             foreach (const QJsonValue& caseVal, casesArray) {
                 QJsonObject caseObj = caseVal.toObject();
@@ -221,6 +237,14 @@ void OJProblemSetModel::loadFromFile(const QString &fileName, int& currentIndex)
                             path.mid(QLatin1String("%ProblemSetPath%/").size());
                 }
                 problemCase->expectedOutputFileName=path;
+                foreach (const QJsonValue& runVal, caseObj["run_history"].toArray()) {
+                    QJsonObject runObj = runVal.toObject();
+                    OJProblemCaseRun run;
+                    run.runningTime = runObj["time"].toVariant().toULongLong();
+                    run.runningMemory = runObj["memory"].toVariant().toULongLong();
+                    run.timestamp = runObj["timestamp"].toVariant().toLongLong();
+                    problemCase->runHistory.append(run);
+                }
                 problemCase->testState = ProblemCaseTestState::NotTested;
                 problem->cases.append(problemCase);
             }
@@ -501,6 +525,25 @@ QVariant OJProblemModel::data(const QModelIndex &index, int role) const
                  return problemCase->runningTime;
              else
                  return "";
+        } else if (role == Qt::ForegroundRole) {
+            POJProblemCase problemCase = mProblem->cases[index.row()];
+            if (problemCase->performanceRegressed)
+                return QColor(Qt::red);
+        } else if (role == Qt::ToolTipRole) {
+            POJProblemCase problemCase = mProblem->cases[index.row()];
+            if (problemCase->runHistory.isEmpty())
+                return QVariant();
+            QString tip = tr("Last %1 runs: min %2ms, median %3ms")
+                    .arg(problemCase->runHistory.count())
+                    .arg(problemCase->minRunningTime())
+                    .arg(problemCase->medianRunningTime());
+            if (problemCase->minRunningMemory()>0)
+                tip += "\n" + tr("Memory: min %1kb, median %2kb")
+                        .arg(problemCase->minRunningMemory()/1024)
+                        .arg(problemCase->medianRunningMemory()/1024);
+            if (problemCase->performanceRegressed)
+                tip += "\n" + tr("The last run is slower than the median.");
+            return tip;
         }
         break;
 #ifdef Q_OS_WIN
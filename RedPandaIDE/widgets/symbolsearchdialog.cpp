@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020-2024 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "symbolsearchdialog.h"
+#include "ui_symbolsearchdialog.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QKeyEvent>
+
+SymbolSearchDialog::SymbolSearchDialog(const PSymbolIndex& index, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::SymbolSearchDialog),
+    mIndex(index)
+{
+    ui->setupUi(this);
+    mSelectedSymbol.line = 0;
+    mSelectedSymbol.kind = StatementKind::Unknown;
+    ui->txtSymbol->installEventFilter(this);
+    ui->lblInfo->setText(tr("%1 symbols").arg(mIndex->count()));
+}
+
+SymbolSearchDialog::~SymbolSearchDialog()
+{
+    delete ui;
+}
+
+const SymbolIndexEntry &SymbolSearchDialog::selectedSymbol() const
+{
+    return mSelectedSymbol;
+}
+
+void SymbolSearchDialog::on_txtSymbol_textChanged(const QString &text)
+{
+    QElapsedTimer timer;
+    timer.start();
+    mResults = mIndex->search(text, 200);
+    qint64 elapsed = timer.elapsed();
+    ui->lstSymbols->clear();
+    foreach (const SymbolSearchResult& result, mResults) {
+        ui->lstSymbols->addItem(QString("%1    %2    %3:%4")
+                                .arg(result.entry.fullName,
+                                     kindName(result.entry.kind),
+                                     QFileInfo(result.entry.fileName).fileName())
+                                .arg(result.entry.line));
+        ui->lstSymbols->item(ui->lstSymbols->count()-1)->setToolTip(result.entry.fileName);
+    }
+    if (ui->lstSymbols->count()>0)
+        ui->lstSymbols->setCurrentRow(0);
+    ui->lblInfo->setText(tr("%1 of %2 symbols (%3 ms)")
+                         .arg(mResults.count())
+                         .arg(mIndex->count())
+                         .arg(elapsed));
+}
+
+void SymbolSearchDialog::on_lstSymbols_itemDoubleClicked(QListWidgetItem *)
+{
+    accept();
+}
+
+QString SymbolSearchDialog::kindName(StatementKind kind)
+{
+    switch(kind) {
+    case StatementKind::Namespace:
+    case StatementKind::NamespaceAlias:
+        return tr("namespace");
+    case StatementKind::Class:
+        return tr("class");
+    case StatementKind::Preprocessor:
+        return tr("macro");
+    case StatementKind::EnumType:
+    case StatementKind::EnumClassType:
+        return tr("enum");
+    case StatementKind::Typedef:
+    case StatementKind::Alias:
+        return tr("typedef");
+    case StatementKind::Constructor:
+        return tr("constructor");
+    case StatementKind::Destructor:
+        return tr("destructor");
+    case StatementKind::Function:
+        return tr("function");
+    case StatementKind::Operator:
+        return tr("operator");
+    case StatementKind::Variable:
+    case StatementKind::GlobalVariable:
+        return tr("variable");
+    case StatementKind::Enum:
+        return tr("enumerator");
+    default:
+        return "";
+    }
+}
+
+bool SymbolSearchDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == ui->txtSymbol && event->type() == QEvent::KeyPress) {
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        int row = ui->lstSymbols->currentRow();
+        switch(keyEvent->key()) {
+        case Qt::Key_Up:
+            if (row>0)
+                ui->lstSymbols->setCurrentRow(row-1);
+            return true;
+        case Qt::Key_Down:
+            if (row+1<ui->lstSymbols->count())
+                ui->lstSymbols->setCurrentRow(row+1);
+            return true;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            accept();
+            return true;
+        default:
+            break;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
+
+void SymbolSearchDialog::accept()
+{
+    int row = ui->lstSymbols->currentRow();
+    if (row<0 || row>=mResults.count())
+        return;
+    mSelectedSymbol = mResults[row].entry;
+    QDialog::accept();
+}
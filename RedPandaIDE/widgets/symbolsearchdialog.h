@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020-2024 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SYMBOLSEARCHDIALOG_H
+#define SYMBOLSEARCHDIALOG_H
+
+#include <QDialog>
+#include <QListWidgetItem>
+#include "../parser/symbolindex.h"
+
+namespace Ui {
+class SymbolSearchDialog;
+}
+
+class SymbolSearchDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SymbolSearchDialog(const PSymbolIndex& index, QWidget *parent = nullptr);
+    ~SymbolSearchDialog();
+    const SymbolIndexEntry& selectedSymbol() const;
+
+private slots:
+    void on_txtSymbol_textChanged(const QString &text);
+    void on_lstSymbols_itemDoubleClicked(QListWidgetItem *item);
+
+private:
+    static QString kindName(StatementKind kind);
+
+private:
+    Ui::SymbolSearchDialog *ui;
+    PSymbolIndex mIndex;
+    QList<SymbolSearchResult> mResults;
+    SymbolIndexEntry mSelectedSymbol;
+
+    // QObject interface
+public:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+    // QDialog interface
+public slots:
+    void accept() override;
+};
+
+#endif // SYMBOLSEARCHDIALOG_H
@@ -43,6 +43,10 @@ target("RedPandaIDE")
         "visithistorymanager.cpp",
         -- compiler
         "compiler/compilerinfo.cpp",
+        "compiler/objectcache.cpp",
+        "compiler/compilerprobecache.cpp",
+        "compiler/caseprocess.cpp",
+        "compiler/ojstresstestrunner.cpp",
         -- debugger
         "debugger/dapprotocol.cpp",
         "debugger/gdbmiresultparser.cpp",
@@ -77,6 +81,7 @@ target("RedPandaIDE")
         "compiler/compilermanager",
         "compiler/executablerunner",
         "compiler/filecompiler",
+        "compiler/nativeprojectcompiler",
         "compiler/ojproblemcasesrunner",
         "compiler/projectcompiler",
         "compiler/runner",
@@ -88,6 +93,7 @@ target("RedPandaIDE")
         -- parser
         "parser/cppparser",
         "parser/statementmodel",
+        "parser/symbolindex",
         -- problems
         "problems/competitivecompenionhandler",
         -- settings dialog
@@ -176,7 +182,8 @@ target("RedPandaIDE")
         "widgets/projectalreadyopendialog",
         "widgets/searchdialog",
         "widgets/searchinfiledialog",
-        "widgets/signalmessagedialog")
+        "widgets/signalmessagedialog",
+        "widgets/symbolsearchdialog")
 
     add_files("*.qrc", "translations/*.ts")
 
@@ -552,7 +552,7 @@ void Document::loadUTF32BOMFile(QFile &file)
     this->setText(text);
 }
 
-void Document::saveUTF16File(QFile &file, TextEncoder &encoder)
+void Document::saveUTF16File(QFileDevice &file, TextEncoder &encoder)
 {
     if (!encoder.isValid())
         return;
@@ -560,7 +560,7 @@ void Document::saveUTF16File(QFile &file, TextEncoder &encoder)
     file.write(encoder.encodeUnchecked(text));
 }
 
-void Document::saveUTF32File(QFile &file, TextEncoder &encoder)
+void Document::saveUTF32File(QFileDevice &file, TextEncoder &encoder)
 {
     if (!encoder.isValid())
         return;
@@ -727,7 +727,7 @@ void Document::loadFromFile(const QString& filename, const QByteArray& encoding,
 
 
 
-void Document::saveToFile(QFile &file, const QByteArray& encoding,
+void Document::saveToFile(QFileDevice &file, const QByteArray& encoding,
                                    const QByteArray& defaultEncoding, QByteArray& realEncoding)
 {
     QMutexLocker locker(&mMutex);
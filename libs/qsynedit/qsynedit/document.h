@@ -497,7 +497,7 @@ public:
     void insertLines(int index, int numLines);
 
     void loadFromFile(const QString& filename, const QByteArray& encoding, QByteArray& realEncoding);
-    void saveToFile(QFile& file, const QByteArray& encoding,
+    void saveToFile(QFileDevice& file, const QByteArray& encoding,
                     const QByteArray& defaultEncoding, QByteArray& realEncoding);
 
     QString glyph(int line, int glyphIdx) const;
@@ -647,8 +647,8 @@ private:
     bool tryLoadFileByEncoding(QByteArray encodingName, QFile& file);
     void loadUTF16BOMFile(QFile& file);
     void loadUTF32BOMFile(QFile& file);
-    void saveUTF16File(QFile& file, TextEncoder &encoder);
-    void saveUTF32File(QFile& file, TextEncoder &encoder);
+    void saveUTF16File(QFileDevice& file, TextEncoder &encoder);
+    void saveUTF32File(QFileDevice& file, TextEncoder &encoder);
 
 private:
     DocumentLines mLines;
@@ -34,10 +34,15 @@ using std::vector;
 #include <sys/wait.h>
 #define MAX_COMMAND_LENGTH 32768
 #define MAX_ERROR_LENGTH 2048
+// layout of the memory shared with Red Panda C++, see compilermanager.h
+#define SHM_SIZE 1024
+#define SHM_USAGE_OFFSET 16
+#define SHM_NOTIFY_PATH_OFFSET 512
 
 enum RunProgramFlag {
     RPF_PAUSE_CONSOLE =     0x0001,
-    RPF_REDIRECT_INPUT =    0x0002
+    RPF_REDIRECT_INPUT =    0x0002,
+    RPF_REPORT_USAGE =      0x0008
 };
 
 
@@ -71,6 +76,49 @@ vector<string> GetCommand(int argc,char** argv,bool &reInp,bool &pauseAfterExit)
     return result;
 }
 
+// Open the fifo Red Panda C++ waits on, so it learns state changes without polling
+int OpenNotifyFifo(const char* pBuf) {
+    if (!pBuf || pBuf[SHM_NOTIFY_PATH_OFFSET]==0)
+        return -1;
+    char path[SHM_SIZE - SHM_NOTIFY_PATH_OFFSET];
+    strncpy(path, pBuf+SHM_NOTIFY_PATH_OFFSET, sizeof(path)-1);
+    path[sizeof(path)-1] = 0;
+    return open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+}
+
+void NotifyIDE(int fd) {
+    if (fd == -1)
+        return;
+    char c = 0;
+    if (write(fd, &c, 1)==-1 && errno!=EAGAIN) {
+        fprintf(stderr,"notify failed %d:%s\n",errno,strerror(errno));
+    }
+}
+
+long long TimevalToUs(const struct timeval& t) {
+    return (long long)t.tv_sec*1000000+t.tv_usec;
+}
+
+// Write the statistics for Red Panda C++. It must be done before "FINISHED" is written.
+void WriteUsage(char* pBuf, int returnValue, long long elapsedUs, const struct rusage& usage) {
+    if (!pBuf)
+        return;
+    // <return value> <elapsed us> <user time us> <system time us> <peak rss kb>
+    // <minor page faults> <major page faults> <voluntary context switches> <involuntary context switches>
+    snprintf(pBuf+SHM_USAGE_OFFSET, SHM_NOTIFY_PATH_OFFSET-SHM_USAGE_OFFSET,
+             "%d %lld %lld %lld %ld %ld %ld %ld %ld\n",
+             returnValue,
+             elapsedUs,
+             TimevalToUs(usage.ru_utime),
+             TimevalToUs(usage.ru_stime),
+             usage.ru_maxrss,
+             usage.ru_minflt,
+             usage.ru_majflt,
+             usage.ru_nvcsw,
+             usage.ru_nivcsw);
+    __sync_synchronize();
+}
+
 string unescapeSpaces(const string& s) {
     string result;
     size_t i=0;
@@ -86,8 +134,8 @@ string unescapeSpaces(const string& s) {
     return result;
 }
 
-int ExecuteCommand(vector<string>& command,bool reInp, long int &peakMemory) {
-    peakMemory = 0;
+int ExecuteCommand(vector<string>& command,bool reInp, struct rusage &usage) {
+    memset(&usage, 0, sizeof(usage));
     pid_t pid = fork();
     if (pid == 0) {
         string path_to_command;
@@ -137,13 +185,11 @@ int ExecuteCommand(vector<string>& command,bool reInp, long int &peakMemory) {
     } else {
         int status;
         pid_t w;
-        struct rusage usage;
         w = wait4(pid, &status, WUNTRACED | WCONTINUED, &usage);
         if (w==-1) {
             fprintf(stderr,"wait4 failed!");
             exit(EXIT_FAILURE);
         }
-        peakMemory = usage.ru_maxrss;
         if (WIFEXITED(status)) {
             return WEXITSTATUS(status);
         } else {
@@ -153,6 +199,52 @@ int ExecuteCommand(vector<string>& command,bool reInp, long int &peakMemory) {
     return 0;
 }
 
+/*
+ * Used by the IDE to run problem cases: argv[2] is the file descriptor the statistics are written to.
+ * The program is forked from this (small) process, so its peak memory isn't polluted by the IDE's,
+ * which is recorded into ru_maxrss when the IDE's forked child calls execve().
+ */
+int RunAndReportUsage(int argc, char** argv) {
+    if (argc < 4) {
+        fprintf(stderr,"Usage: consolepauser <flags> <stats_fd> <filename> <parameters>\n");
+        return EXIT_FAILURE;
+    }
+    int fd = atoi(argv[2]);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execv(argv[3],argv+3);
+        fprintf(stderr,"Failed to start command %s!\n",argv[3]);
+        fprintf(stderr,"errno %d: %s\n",errno,strerror(errno));
+        _exit(127);
+    } else if (pid < 0) {
+        fprintf(stderr,"fork failed %d:%s\n",errno,strerror(errno));
+        return 127;
+    }
+    int status;
+    struct rusage usage;
+    pid_t w;
+    do {
+        w = wait4(pid, &status, 0, &usage);
+    } while (w==-1 && errno==EINTR);
+    if (w==-1) {
+        fprintf(stderr,"wait4 failed!");
+        return EXIT_FAILURE;
+    }
+    // <wait status> <user time in us> <system time in us> <peak rss in kb>
+    char buf[128];
+    int len = snprintf(buf, sizeof(buf), "%d %lld %lld %ld\n",
+                       status,
+                       (long long)usage.ru_utime.tv_sec*1000000+usage.ru_utime.tv_usec,
+                       (long long)usage.ru_stime.tv_sec*1000000+usage.ru_stime.tv_usec,
+                       usage.ru_maxrss);
+    if (write(fd, buf, len)!=len) {
+        fprintf(stderr,"write usage failed %d:%s\n",errno,strerror(errno));
+    }
+    close(fd);
+    return WIFEXITED(status)?WEXITSTATUS(status):128+WTERMSIG(status);
+}
+
 int main(int argc, char** argv) {
     char* sharedMemoryId;
     // First make sure we aren't going to read nonexistent arrays
@@ -163,6 +255,9 @@ int main(int argc, char** argv) {
         PauseExit(EXIT_SUCCESS,false);
     }
 
+    if (atoi(argv[1]) & RPF_REPORT_USAGE)
+        return RunAndReportUsage(argc, argv);
+
     // Make us look like the paused program
     //SetConsoleTitleA(argv[3]);
     sharedMemoryId = argv[2];
@@ -178,7 +273,7 @@ int main(int argc, char** argv) {
         fflush(stdin);
     }
 
-    int BUF_SIZE=1024;
+    int BUF_SIZE=SHM_SIZE;
     char* pBuf=nullptr;
     int fd_shm = shm_open(sharedMemoryId,O_RDWR,S_IRWXU);
     if (fd_shm==-1) {
@@ -192,31 +287,37 @@ int main(int argc, char** argv) {
             pBuf = nullptr;
         }
     }
+    int fd_notify = OpenNotifyFifo(pBuf);
 
     // Save starting timestamp
     auto starttime = std::chrono::high_resolution_clock::now();
 
     // Execute the command
-    long int peakMemory;
-    int returnvalue = ExecuteCommand(command,reInp, peakMemory);
+    struct rusage usage;
+    int returnvalue = ExecuteCommand(command,reInp, usage);
 
     // Get ending timestamp
     auto endtime = std::chrono::high_resolution_clock::now();
     auto difftime = endtime - starttime;
-    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(difftime);
-    double seconds = milliseconds.count()/1000.0;
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(difftime);
+    double seconds = microseconds.count()/1000000.0;
+    double cpuMilliseconds = (TimevalToUs(usage.ru_utime)+TimevalToUs(usage.ru_stime))/1000.0;
 
     if (pBuf) {
+        WriteUsage(pBuf, returnvalue, microseconds.count(), usage);
         strcpy(pBuf,"FINISHED");
         munmap(pBuf,BUF_SIZE);
     }
     if (fd_shm!=-1) {
         shm_unlink(sharedMemoryId);
     }
+    NotifyIDE(fd_notify);
+    if (fd_notify!=-1)
+        close(fd_notify);
 
     // Done? Print return value of executed program
     printf("\n--------------------------------");
-    printf("\nProcess exited after %.4g seconds with return value %d, %ld KB mem used.\n",seconds,returnvalue,peakMemory);
+    printf("\nProcess exited after %.4g seconds with return value %d (%.4g ms cpu time, %ld KB mem used).\n",seconds,returnvalue,cpuMilliseconds,usage.ru_maxrss);
     if (pauseAfterExit)
         PauseExit(returnvalue,reInp);
     return 0;